@@ -46,6 +46,11 @@ WS2812B ws_leds = WS2812B(3);
 
 void setup()
 {
+    // Paint free RAM before anything else uses the stack
+#ifdef MEMORY_MONITOR
+    memory_setup();
+#endif
+
     // EEPROM setup
     EEPROM.PageBase0 = 0x801F000;
     EEPROM.PageBase1 = 0x801F800;
@@ -63,7 +68,7 @@ void setup()
     TELEMETRY_SERIAL.begin(TELEMETRY_BAUDRATE);
     delay(250);
 #ifdef DEBUGGER
-    DEBUG_SERIAL.begin(TELEMETRY_BAUDRATE);
+    DEBUG_SERIAL.begin(DEBUGGER_BAUDRATE);
     delay(250);
 #endif
     gps_setup();
@@ -199,7 +204,7 @@ void loop()
             telemetry();
 
             // Immediately reset the counter if in liberty-link mode
-            if (telemetry_loop_counter >= 34) {
+            if (telemetry_loop_counter >= TELEMETRY_CHECK_BYTE_N + 2) {
                 telemetry_loop_counter = 0;
                 break;
             }
@@ -221,6 +226,11 @@ void loop()
     debugger();
 #endif
 
+    // Stack high-water mark and free RAM
+#ifdef MEMORY_MONITOR
+    memory_check();
+#endif
+
     // Check loop time
     if (micros() - loop_timer > MAX_ALLOWED_LOOP_PERIOD) {
         // Set error status
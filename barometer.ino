@@ -59,6 +59,9 @@ void barometer_setup(void) {
 	OFF_C2 = C[2] * (int64_t)65536;
 	SENS_C1 = C[1] * (int64_t)32768;
 
+	// Calculate initial OFF and SENS values (they will be updated with every new temperature)
+	barometer_compensate_temperature();
+
     // Stabilize pressure with a few readings
     for (count_var = 0; count_var < 500; count_var++) {
         // Read barometer data
@@ -116,6 +119,9 @@ void barometer_handler(void) {
                 average_temperature_mem_location = 0;
             // Calculate the avarage temperature of the last 5 measurements
             raw_temperature = raw_average_temperature_total / 5;
+            // Recalculate OFF and SENS only if the average temperature has changed
+            if (raw_temperature != raw_temperature_previous)
+                barometer_compensate_temperature();
         }
         else {
             // Get pressure data from MS-5611
@@ -145,13 +151,9 @@ void barometer_handler(void) {
     }
     if (barometer_counter == 2) {
         // Step 2. Calculate pressure as explained in the datasheet of the MS-5611
-        dT = C[5];
-        dT <<= 8;
-        dT *= -1;
-        dT += raw_temperature;
-        OFF = OFF_C2 + ((int64_t)dT * (int64_t)C[4]) / 128LL;
-        SENS = SENS_C1 + ((int64_t)dT * (int64_t)C[3]) / 256LL;
-        P = ((raw_pressure * SENS) / 2097152UL - OFF) / 32768UL; 2000L + dT * C[6] / 8388608L;
+        // OFF and SENS are pre-calculated in barometer_compensate_temperature()
+        // Division helpers are shifts, so the product is only a 64-bit multiply (umull + mla) without libgcc calls
+        P = barometer_div_pow2(barometer_div_pow2((int64_t)raw_pressure * SENS, 21) - OFF, 15);
 
         // 20 location rotating memory to get a smoother pressure value
         // Subtract the current memory position to make room for the new value
@@ -216,3 +218,52 @@ void barometer_handler(void) {
         }
     }
 }
+
+/// <summary>
+/// Calculates temperature compensated OFF and SENS values as explained in the datasheet of the MS-5611
+/// Called only when the average raw temperature has changed to offload the main program loop
+/// </summary>
+void barometer_compensate_temperature(void) {
+    // Store current temperature
+    raw_temperature_previous = raw_temperature;
+
+    // Difference between actual and reference temperature
+    dT = C[5];
+    dT <<= 8;
+    dT *= -1;
+    dT += raw_temperature;
+
+    // Offset and sensitivity at actual temperature
+    OFF = OFF_C2 + barometer_div_pow2((int64_t)dT * (int64_t)C[4], 7);
+    SENS = SENS_C1 + barometer_div_pow2((int64_t)dT * (int64_t)C[3], 8);
+
+#ifdef BAROMETER_SECOND_ORDER
+    // Actual temperature (2000 = 20.00 C)
+    TEMP = 2000 + (int32_t)barometer_div_pow2((int64_t)dT * (int64_t)C[6], 23);
+
+    // Second order temperature compensation (only below 20 C)
+    if (TEMP < 2000) {
+        OFF2 = (int64_t)5 * (TEMP - 2000) * (TEMP - 2000) / 2;
+        SENS2 = (int64_t)5 * (TEMP - 2000) * (TEMP - 2000) / 4;
+
+        // Very low temperature (below -15 C)
+        if (TEMP < -1500) {
+            OFF2 += (int64_t)7 * (TEMP + 1500) * (TEMP + 1500);
+            SENS2 += (int64_t)11 * (TEMP + 1500) * (TEMP + 1500) / 2;
+        }
+
+        OFF -= OFF2;
+        SENS -= SENS2;
+    }
+#endif
+}
+
+/// <summary>
+/// Divides signed value by 2^shift with a shift instead of the slow 64-bit division
+/// Rounds towards zero, so the result is the same as with the / operator
+/// </summary>
+int64_t barometer_div_pow2(int64_t value, uint8_t shift) {
+    if (value < 0)
+        value += ((int64_t)1 << shift) - 1;
+    return value >> shift;
+}
@@ -106,6 +106,10 @@ const float PRESSURE_SP_FACTOR PROGMEM = 0.0003;
 // Stabilize pressure in 1000 * 4ms = 4000ms
 const uint16_t PRESSURE_STAB_N PROGMEM = 1000;
 
+// Second order temperature compensation of the MS5611 (improves accuracy below 20 C)
+// Comment to use only the first order compensation
+#define BAROMETER_SECOND_ORDER
+
 
 /*****************************/
 /*            GPS            */
@@ -191,15 +195,21 @@ const int32_t GPS_SETPOINT_MAX_DISTANCE PROGMEM = 5;
 // How many pascals to reduce the pressure (raise the altitude) before GPS flight
 const float LINK_PRESSURE_ASCEND PROGMEM = 12;
 
-// GPS waypoint move speed factor on short distances (default = 0.05, larger = faster)
-const float WAYPOINT_GPS_MIN_FACTOR PROGMEM = 0.015;
+// Max GPS waypoint move speed in GPS units per loop (0.08 * 0.11m / 4ms ~ 2.2m/s)
+const float WAYPOINT_GPS_MAX_SPEED PROGMEM = 0.08;
 
-// GPS waypoint move speed factor on large distances (default = 0.20, larger = faster)
-const float WAYPOINT_GPS_MAX_FACTOR PROGMEM = 0.05;
+// GPS waypoint acceleration and deceleration in GPS units per loop^2 (0.0002 * 0.11m / 4ms^2 ~ 1.4m/s^2)
+const float WAYPOINT_GPS_ACCELERATION PROGMEM = 0.0002;
 
-// Altitude waypoint move speed term (default = 0.022, larger = faster)
+// Max altitude waypoint move speed in pascals per loop (default = 0.022, larger = faster)
 const float WAYPOINT_ALTITUDE_TERM PROGMEM = 0.025;
 
+// Altitude waypoint acceleration and deceleration in pascals per loop^2 (default = 0.0001, larger = sharper)
+const float WAYPOINT_ALTITUDE_ACCELERATION PROGMEM = 0.0001;
+
+// Descent speed in pascals per loop if the ground is not reached at the end of the descent profile
+const float WAYPOINT_ALTITUDE_CREEP_TERM PROGMEM = 0.01;
+
 // How many pascals to reduce the pressure (raise the altitude) when the direct control aborted
 const float ABORT_PRESSURE_ASCEND PROGMEM = 5;
 
@@ -249,34 +259,60 @@ const uint8_t BURST_BYTES PROGMEM = 4;
 #endif
 
 
+/****************************************/
+/*            Memory monitor            */
+/****************************************/
+// Paints free RAM at startup and tracks stack high-water mark, heap and static RAM usage
+#define MEMORY_MONITOR
+
+#ifdef MEMORY_MONITOR
+// Bytes above the heap that will not be painted (to leave room for allocations after setup)
+const uint32_t MEMORY_HEAP_MARGIN PROGMEM = 256;
+
+// How many words of the painted RAM will be checked every loop (20KB / 4 / 64 ~ 80 loops per full pass)
+const uint16_t MEMORY_SCAN_WORDS PROGMEM = 64;
+
+// Append stack usage, free RAM, heap usage and static RAM usage to the telemetry packet
+// (8 bytes more, not supported by old ground stations)
+//#define TELEMETRY_MEMORY_REPORT
+#endif
+
+
 /**********************************/
 /*            Debugger            */
 /**********************************/
 //#define DEBUGGER
 
+// Variables and sample rate are selected at runtime by the host (see tools/debugger_scope.py)
+// Only variables listed in the DEBUG_REGISTRY (debugger.ino) can be selected
 #ifdef DEBUGGER
-// Send debug every 25 * 4ms = 100ms
-const uint16_t DEBUG_SEND_CYCLES PROGMEM = 25;
-
-// Variables to debug
-#define DEBUG_VAR_1				angle_yaw
-#define DEBUG_VAR_2				actual_compass_heading
-//#define DEBUG_VAR_3				gps_roll_adjust
-//#define DEBUG_VAR_4				gps_pitch_adjust
+// Unique pair of sync bytes (at the beginning of each frame)
+const uint8_t DEBUG_SUFFIX_1 PROGMEM = 0xEE;
+const uint8_t DEBUG_SUFFIX_2 PROGMEM = 0xEF;
+
+// Maximum number of variables in one sample
+#define DEBUG_CHANNELS_MAX		8
+
+// How many bytes will be pushed to the serial port every loop (115200 baud ~ 46 bytes per 4ms)
+const uint8_t DEBUG_BURST_BYTES PROGMEM = 40;
 #endif
 
 
 /**************************************/
 /*            Serial ports            */
 /**************************************/
-// Telemetry, Liberty-Link and debugger port
+// Telemetry and Liberty-Link port
 #define TELEMETRY_SERIAL		Serial1
 
 // GPS port
 #define GPS_SERIAL				Serial2
 
-// DEBUG port
-#define DEBUG_SERIAL				Serial2
+// DEBUG port (USB, because Serial2 is used by GPS and Serial3 pins are used by I2C)
+// Serial is USB only if the sketch is uploaded with the STM32duino bootloader (SERIAL_USB), otherwise it is Serial1
+#define DEBUG_SERIAL				Serial
+#if defined(DEBUGGER) && !defined(SERIAL_USB)
+#error "DEBUGGER needs USB serial (upload method: STM32duino bootloader), Serial1 is used by telemetry and Liberty-Link"
+#endif
 
 // Telemetry and Liberty-Link port baud rate
 const uint32_t TELEMETRY_BAUDRATE PROGMEM = 115200;
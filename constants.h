@@ -46,6 +46,22 @@ const uint8_t SONARUS_ADDRESS PROGMEM = 0xEE;
 #endif
 const uint8_t VOLTMETER_PIN PROGMEM = 4;
 
+// STM32F103C8 SRAM (20KB). The stack starts at the end of the SRAM
+const uint32_t SRAM_START PROGMEM = 0x20000000;
+const uint32_t SRAM_END PROGMEM = 0x20005000;
+
+#ifdef MEMORY_MONITOR
+// Value of the unused RAM
+const uint32_t MEMORY_PAINT_PATTERN PROGMEM = 0xA5A5A5A5;
+#endif
+
+// Telemetry packet length (without suffix)
+#if defined(MEMORY_MONITOR) && defined(TELEMETRY_MEMORY_REPORT)
+#define TELEMETRY_CHECK_BYTE_N			40
+#else
+#define TELEMETRY_CHECK_BYTE_N			32
+#endif
+
 // Startup error codes
 #define ERROR_BOOT_IMU					1
 #define ERROR_BOOT_COMPASS				2
@@ -78,6 +94,10 @@ const uint8_t VOLTMETER_PIN PROGMEM = 4;
 #define LINK_STEP_SONARUS		7
 #define LINK_STEP_AFTER_SONARUS	8
 
+// Trajectory generator axes
+#define TRAJECTORY_GPS			0
+#define TRAJECTORY_ALTITUDE		1
+
 // Liberty-Link waypoint commands (bits)
 #define WAYP_CMD_BITS_SKIP				0b000
 #define WAYP_CMD_BITS_DDC_NO_GPS_NO_DSC	0b001
@@ -98,4 +118,23 @@ const uint8_t VOLTMETER_PIN PROGMEM = 4;
 
 #endif
 
+// Debugger variable types
+#ifdef DEBUGGER
+#define DEBUG_TYPE_UINT8		0
+#define DEBUG_TYPE_INT8			1
+#define DEBUG_TYPE_UINT16		2
+#define DEBUG_TYPE_INT16		3
+#define DEBUG_TYPE_UINT32		4
+#define DEBUG_TYPE_INT32		5
+#define DEBUG_TYPE_FLOAT		6
+
+// Debugger commands (host -> flight controller)
+#define DEBUG_CMD_LIST			1
+#define DEBUG_CMD_SELECT		2
+
+// Debugger frame types (flight controller -> host)
+#define DEBUG_FRAME_VARIABLE	1
+#define DEBUG_FRAME_SAMPLE		2
+#endif
+
 #endif
@@ -83,13 +83,17 @@ int32_t acc_alt_integrated;
 uint16_t C[7];
 uint8_t barometer_counter, temperature_counter, average_temperature_mem_location;
 int64_t OFF, OFF_C2, SENS, SENS_C1, P;
-uint32_t raw_pressure, raw_temperature, temp, raw_temperature_rotating_memory[5], raw_average_temperature_total;
+uint32_t raw_pressure, raw_temperature, raw_temperature_previous, temp, raw_temperature_rotating_memory[5], raw_average_temperature_total;
 float actual_pressure, actual_pressure_slow, actual_pressure_fast, actual_pressure_diff;
 float ground_pressure, altutude_hold_pressure, return_to_home_decrease;
 int32_t pressure_rotating_mem[20], pressure_total_avarage;
 uint8_t pressure_rotating_mem_location;
 float pressure_rotating_mem_actual;
 int32_t dT, dT_C5;
+#ifdef BAROMETER_SECOND_ORDER
+int32_t TEMP;
+int64_t OFF2, SENS2;
+#endif
 
 // Altitude hold PID
 float pid_i_mem_alt, pid_alt_setpoint, pid_output_alt, pid_error_gain_altitude;
@@ -156,10 +160,21 @@ boolean link_takeoff_flag;
 int32_t waypoints_lat[16], waypoints_lon[16];
 uint8_t waypoints_command[16], waypoint_command;
 uint8_t waypoints_index;
-int32_t l_lat_waypoint, l_lon_waypoint, l_lat_waypoint_last, l_lon_waypoint_last;
-float waypoint_lat_factor, waypoint_lon_factor, waypoint_move_factor;
+int32_t l_lat_waypoint, l_lon_waypoint;
 float waypoint_course;
 int16_t waypoint_yaw_correction;
+
+// Trajectory generator
+uint32_t trajectory_time[2];
+float trajectory_distance[2], trajectory_acceleration[2], trajectory_velocity_cruise[2];
+float trajectory_time_accelerate[2], trajectory_time_decelerate[2], trajectory_time_total[2], trajectory_distance_accelerate[2];
+float trajectory_position[2], trajectory_velocity[2], trajectory_velocity_initial[2];
+float trajectory_time_temp, trajectory_distance_temp, trajectory_setpoint_temp;
+int32_t trajectory_lat_start, trajectory_lon_start;
+float trajectory_lat_start_adjust, trajectory_lon_start_adjust;
+float trajectory_lat_direction, trajectory_lon_direction, trajectory_lon_scale;
+float trajectory_alt_start, trajectory_alt_setpoint, trajectory_alt_direction;
+float trajectory_lat_velocity, trajectory_lon_velocity, trajectory_alt_velocity;
 #endif
 
 // Telemetry
@@ -197,9 +212,26 @@ float lux_data;
 uint8_t lux_sqrt_data;
 #endif
 
+// Memory monitor
+#ifdef MEMORY_MONITOR
+uint32_t *memory_paint_start, *memory_stack_lowest, *memory_scan_pointer, *memory_temp_pointer;
+uint16_t memory_scan_counter;
+uint32_t memory_heap_start, memory_heap_end;
+uint32_t memory_static_ram, memory_heap_used, memory_stack_used, memory_free;
+#endif
+
 // Debugger
 #ifdef DEBUGGER
-uint16_t debugger_loop_counter;
+struct debug_variable_t {
+	const char *name;
+	void *pointer;
+	uint8_t type;
+};
+uint16_t debugger_loop_counter, debug_divider, debug_sample_counter;
+uint8_t debug_channels[DEBUG_CHANNELS_MAX], debug_channels_number;
+uint8_t debug_rx_buffer[13], debug_rx_counter, debug_rx_byte_previous, debug_rx_check_byte;
+uint8_t debug_tx_buffer[256], debug_tx_head, debug_tx_tail, debug_tx_check_byte;
+uint8_t debug_list_index = UINT8_MAX, debug_temp_byte;
 #endif
 #endif
 
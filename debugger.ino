@@ -29,47 +29,269 @@
 
 #ifdef DEBUGGER
 
-/// <summary>
-/// Prints up to four variables to the serial port
-/// </summary>
-void debugger(void) {
-	// Increment counter
-	debugger_loop_counter++;
+// Variables that can be selected by the host. Index in this array is used as the variable ID
+const debug_variable_t DEBUG_REGISTRY[] PROGMEM = {
+	// Common
+	{ "start", &start, DEBUG_TYPE_UINT8 },
+	{ "flight_mode", &flight_mode, DEBUG_TYPE_UINT8 },
+	{ "error", &error, DEBUG_TYPE_UINT8 },
 
-	if (debugger_loop_counter >= DEBUG_SEND_CYCLES) {
-		// Reset counter
-		debugger_loop_counter = 0;
+	// Motors
+	{ "esc_1", &esc_1, DEBUG_TYPE_INT16 },
+	{ "esc_2", &esc_2, DEBUG_TYPE_INT16 },
+	{ "esc_3", &esc_3, DEBUG_TYPE_INT16 },
+	{ "esc_4", &esc_4, DEBUG_TYPE_INT16 },
+	{ "throttle", &throttle, DEBUG_TYPE_INT16 },
+	{ "battery_voltage", &battery_voltage, DEBUG_TYPE_FLOAT },
 
-#ifdef DEBUG_VAR_1
-		// First variable
-		DEBUG_SERIAL.print(DEBUG_VAR_1);
-		DEBUG_SERIAL.print('\t');
-#endif
+	// IMU and angles
+	{ "acc_x", &acc_x, DEBUG_TYPE_INT16 },
+	{ "acc_y", &acc_y, DEBUG_TYPE_INT16 },
+	{ "acc_z", &acc_z, DEBUG_TYPE_INT16 },
+	{ "gyro_roll", &gyro_roll, DEBUG_TYPE_INT16 },
+	{ "gyro_pitch", &gyro_pitch, DEBUG_TYPE_INT16 },
+	{ "gyro_yaw", &gyro_yaw, DEBUG_TYPE_INT16 },
+	{ "angle_roll", &angle_roll, DEBUG_TYPE_FLOAT },
+	{ "angle_pitch", &angle_pitch, DEBUG_TYPE_FLOAT },
+	{ "angle_yaw", &angle_yaw, DEBUG_TYPE_FLOAT },
+	{ "actual_compass_heading", &actual_compass_heading, DEBUG_TYPE_FLOAT },
+
+	// PID
+	{ "pid_roll_setpoint", &pid_roll_setpoint, DEBUG_TYPE_FLOAT },
+	{ "pid_pitch_setpoint", &pid_pitch_setpoint, DEBUG_TYPE_FLOAT },
+	{ "pid_yaw_setpoint", &pid_yaw_setpoint, DEBUG_TYPE_FLOAT },
+	{ "pid_output_roll", &pid_output_roll, DEBUG_TYPE_FLOAT },
+	{ "pid_output_pitch", &pid_output_pitch, DEBUG_TYPE_FLOAT },
+	{ "pid_output_yaw", &pid_output_yaw, DEBUG_TYPE_FLOAT },
+
+	// Barometer and altitude
+	{ "actual_pressure", &actual_pressure, DEBUG_TYPE_FLOAT },
+	{ "actual_pressure_fast", &actual_pressure_fast, DEBUG_TYPE_FLOAT },
+	{ "ground_pressure", &ground_pressure, DEBUG_TYPE_FLOAT },
+	{ "pid_alt_setpoint", &pid_alt_setpoint, DEBUG_TYPE_FLOAT },
+	{ "pid_output_alt", &pid_output_alt, DEBUG_TYPE_FLOAT },
+	{ "acc_alt_integrated", &acc_alt_integrated, DEBUG_TYPE_INT32 },
+
+	// GPS
+	{ "l_lat_gps", &l_lat_gps, DEBUG_TYPE_INT32 },
+	{ "l_lon_gps", &l_lon_gps, DEBUG_TYPE_INT32 },
+	{ "l_lat_setpoint", &l_lat_setpoint, DEBUG_TYPE_INT32 },
+	{ "l_lon_setpoint", &l_lon_setpoint, DEBUG_TYPE_INT32 },
+	{ "number_used_sats", &number_used_sats, DEBUG_TYPE_UINT8 },
+	{ "gps_roll_adjust", &gps_roll_adjust, DEBUG_TYPE_FLOAT },
+	{ "gps_pitch_adjust", &gps_pitch_adjust, DEBUG_TYPE_FLOAT },
+
+	// Receiver
+	{ "channel_1", &channel_1, DEBUG_TYPE_INT32 },
+	{ "channel_2", &channel_2, DEBUG_TYPE_INT32 },
+	{ "channel_3", &channel_3, DEBUG_TYPE_INT32 },
+	{ "channel_4", &channel_4, DEBUG_TYPE_INT32 },
+	{ "takeoff_detected", &takeoff_detected, DEBUG_TYPE_UINT8 },
 
-#ifdef DEBUG_VAR_2
-		// Second variable
-		DEBUG_SERIAL.print(DEBUG_VAR_2);
-		DEBUG_SERIAL.print('\t');
+#ifdef LIBERTY_LINK
+	// Liberty-Link
+	{ "link_waypoint_step", &link_waypoint_step, DEBUG_TYPE_UINT8 },
+	{ "waypoints_index", &waypoints_index, DEBUG_TYPE_UINT8 },
+	{ "l_lat_waypoint", &l_lat_waypoint, DEBUG_TYPE_INT32 },
+	{ "l_lon_waypoint", &l_lon_waypoint, DEBUG_TYPE_INT32 },
+	{ "trajectory_lat_velocity", &trajectory_lat_velocity, DEBUG_TYPE_FLOAT },
+	{ "trajectory_lon_velocity", &trajectory_lon_velocity, DEBUG_TYPE_FLOAT },
+	{ "trajectory_alt_velocity", &trajectory_alt_velocity, DEBUG_TYPE_FLOAT },
 #endif
 
-#ifdef DEBUG_VAR_3
-		// Third variable
-		DEBUG_SERIAL.print(DEBUG_VAR_3);
-		DEBUG_SERIAL.print('\t');
+#ifdef SONARUS
+	// Sonarus
+	{ "sonarus_front", &sonarus_front, DEBUG_TYPE_UINT16 },
+	{ "sonarus_bottom", &sonarus_bottom, DEBUG_TYPE_UINT16 },
 #endif
 
-#ifdef DEBUG_VAR_4
-		// Fourth variable
-		DEBUG_SERIAL.print(DEBUG_VAR_4);
-		DEBUG_SERIAL.print('\t');
+#ifdef LUX_METER
+	// Lux meter
+	{ "lux_data", &lux_data, DEBUG_TYPE_FLOAT },
 #endif
 
-#if defined(DEBUG_VAR_1) || defined(DEBUG_VAR_2) || defined(DEBUG_VAR_3) || defined(DEBUG_VAR_4)
-		// New line
-		DEBUG_SERIAL.println();
+#ifdef MEMORY_MONITOR
+	// Memory monitor
+	{ "memory_static_ram", &memory_static_ram, DEBUG_TYPE_UINT32 },
+	{ "memory_heap_used", &memory_heap_used, DEBUG_TYPE_UINT32 },
+	{ "memory_stack_used", &memory_stack_used, DEBUG_TYPE_UINT32 },
+	{ "memory_free", &memory_free, DEBUG_TYPE_UINT32 },
 #endif
+};
+
+// Number of variables in the registry
+const uint8_t DEBUG_REGISTRY_SIZE PROGMEM = sizeof(DEBUG_REGISTRY) / sizeof(DEBUG_REGISTRY[0]);
+
+// Size of each variable type in bytes (index is DEBUG_TYPE_...)
+const uint8_t DEBUG_TYPE_SIZES[] PROGMEM = { 1, 1, 2, 2, 4, 4, 4 };
+
+/// <summary>
+/// Receives commands from the host, samples selected variables and streams them as binary frames
+/// Host -> FC frame: CMD, DIVIDER, 8 x CHANNEL, CHECK, SUFFIX_1, SUFFIX_2
+/// FC -> host frame: SUFFIX_1, SUFFIX_2, TYPE, LENGTH, PAYLOAD, CHECK (XOR of TYPE, LENGTH and PAYLOAD)
+/// Multi-byte values are little-endian
+/// </summary>
+void debugger(void) {
+	// Parse commands from the host
+	debugger_receive();
+
+	// Send one variable description per loop if the list is requested
+	if (debug_list_index < DEBUG_REGISTRY_SIZE) {
+		if (debugger_push_variable(debug_list_index))
+			debug_list_index++;
 	}
+
+	// Sample selected variables every debug_divider loops
+	else if (debug_channels_number) {
+		debugger_loop_counter++;
+		if (debugger_loop_counter >= debug_divider) {
+			// Reset counter
+			debugger_loop_counter = 0;
+
+			// Skip the sample if there is no space in the buffer. The host will see the gap in the sample counter
+			debugger_push_sample();
+			debug_sample_counter++;
+		}
+	}
+
+	// Push a limited number of bytes per loop to prevent blocking
+	for (debug_temp_byte = 0; debug_temp_byte < DEBUG_BURST_BYTES && debug_tx_tail != debug_tx_head; debug_temp_byte++)
+		DEBUG_SERIAL.write(debug_tx_buffer[debug_tx_tail++]);
 }
 
-#endif
+/// <summary>
+/// Reads commands from the host
+/// </summary>
+void debugger_receive(void) {
+	while (DEBUG_SERIAL.available()) {
+		// Read current byte
+		debug_rx_buffer[debug_rx_counter] = DEBUG_SERIAL.read();
+
+		if (debug_rx_byte_previous == DEBUG_SUFFIX_1 && debug_rx_buffer[debug_rx_counter] == DEBUG_SUFFIX_2) {
+			// If data suffix appears
+			// Calculate check sum
+			debug_rx_check_byte = 0;
+			for (debug_temp_byte = 0; debug_temp_byte <= 9; debug_temp_byte++)
+				debug_rx_check_byte ^= debug_rx_buffer[debug_temp_byte];
+
+			// Accept only full 13-byte frames (second suffix at index 12) with the valid check sum
+			if (debug_rx_counter == 12 && debug_rx_check_byte == debug_rx_buffer[10]) {
+				// Start sending the list of variables
+				if (debug_rx_buffer[0] == DEBUG_CMD_LIST)
+					debug_list_index = 0;
+
+				// Select variables and sample divider
+				else if (debug_rx_buffer[0] == DEBUG_CMD_SELECT) {
+					debug_divider = debug_rx_buffer[1];
+					if (debug_divider < 1)
+						debug_divider = 1;
+
+					// Store only valid indexes (0xFF - unused channel)
+					debug_channels_number = 0;
+					for (debug_temp_byte = 2; debug_temp_byte < 2 + DEBUG_CHANNELS_MAX; debug_temp_byte++)
+						if (debug_rx_buffer[debug_temp_byte] < DEBUG_REGISTRY_SIZE)
+							debug_channels[debug_channels_number++] = debug_rx_buffer[debug_temp_byte];
+
+					// Restart sampling
+					debugger_loop_counter = 0;
+					debug_sample_counter = 0;
+				}
+			}
+
+			// Reset buffer position
+			debug_rx_counter = 0;
+		}
+		else {
+			// Store data bytes
+			debug_rx_byte_previous = debug_rx_buffer[debug_rx_counter];
+			debug_rx_counter++;
+
+			// Reset buffer on overflow
+			if (debug_rx_counter > 12)
+				debug_rx_counter = 0;
+		}
+	}
+}
 
+/// <summary>
+/// Puts description of the variable (index, type and name) to the transmit buffer
+/// </summary>
+/// <param name="index">Index of the variable in the DEBUG_REGISTRY</param>
+/// <returns>1 if the frame is added, 0 if there is not enough space in the buffer</returns>
+boolean debugger_push_variable(uint8_t index) {
+	// Name length is limited by the length byte
+	count_var = strlen(DEBUG_REGISTRY[index].name);
+	if (count_var > 200)
+		count_var = 200;
+
+	if (!debugger_begin_frame(DEBUG_FRAME_VARIABLE, count_var + 2))
+		return 0;
+
+	debugger_push_byte(index);
+	debugger_push_byte(DEBUG_REGISTRY[index].type);
+	for (debug_temp_byte = 0; debug_temp_byte < count_var; debug_temp_byte++)
+		debugger_push_byte(DEBUG_REGISTRY[index].name[debug_temp_byte]);
+
+	debugger_end_frame();
+	return 1;
+}
+
+/// <summary>
+/// Puts sample counter and raw values of the selected variables to the transmit buffer
+/// </summary>
+void debugger_push_sample(void) {
+	// Calculate payload length
+	count_var = 2;
+	for (debug_temp_byte = 0; debug_temp_byte < debug_channels_number; debug_temp_byte++)
+		count_var += DEBUG_TYPE_SIZES[DEBUG_REGISTRY[debug_channels[debug_temp_byte]].type];
+
+	if (!debugger_begin_frame(DEBUG_FRAME_SAMPLE, count_var))
+		return;
+
+	// Sample counter
+	debugger_push_byte(debug_sample_counter);
+	debugger_push_byte(debug_sample_counter >> 8);
+
+	// Raw bytes of each variable
+	for (debug_temp_byte = 0; debug_temp_byte < debug_channels_number; debug_temp_byte++)
+		for (count_var = 0; count_var < DEBUG_TYPE_SIZES[DEBUG_REGISTRY[debug_channels[debug_temp_byte]].type]; count_var++)
+			debugger_push_byte(((uint8_t *)DEBUG_REGISTRY[debug_channels[debug_temp_byte]].pointer)[count_var]);
+
+	debugger_end_frame();
+}
+
+/// <summary>
+/// Puts sync bytes, frame type and length to the transmit buffer
+/// </summary>
+/// <returns>1 if there is enough space for the whole frame, 0 if not</returns>
+boolean debugger_begin_frame(uint8_t type, uint8_t length) {
+	// Sync bytes, type, length, payload and check byte must fit in the free space
+	if ((uint8_t)(debug_tx_tail - debug_tx_head - 1) < length + 5)
+		return 0;
+
+	debugger_push_byte(DEBUG_SUFFIX_1);
+	debugger_push_byte(DEBUG_SUFFIX_2);
+
+	// Check byte covers type, length and payload
+	debug_tx_check_byte = 0;
+	debugger_push_byte(type);
+	debugger_push_byte(length);
+	return 1;
+}
+
+/// <summary>
+/// Puts check byte to the transmit buffer
+/// </summary>
+void debugger_end_frame(void) {
+	debug_tx_buffer[debug_tx_head++] = debug_tx_check_byte;
+}
+
+/// <summary>
+/// Puts one byte to the transmit buffer and XORs it into the check byte
+/// </summary>
+void debugger_push_byte(uint8_t data) {
+	debug_tx_check_byte ^= data;
+	debug_tx_buffer[debug_tx_head++] = data;
+}
+
+#endif
@@ -34,6 +34,9 @@
  /// For more please visit https://github.com/XxOinvizioNxX/Liberty-Way
  /// </summary>
 void liberty_link_handler(void) {
+    // Reset velocity feed-forward (it will be set again by the trajectory generator)
+    trajectory_reset_feed_forward();
+
     // Clear direct_control flag if LibertyLink is lost
     if (!link_allowed || link_lost_counter >= LINK_LOST_CYCLES)
         link_direct_control = 0;
@@ -76,20 +79,17 @@ void liberty_link_handler(void) {
         if (link_waypoint_step == LINK_STEP_TAKEOFF) {
             // Go to ascending if takeoff detected
             if (takeoff_detected)
-                link_waypoint_step = LINK_STEP_ASCENT;
+                link_start_ascent();
         }
 
         // ---------------------------------------------
         // Step ASCENT. Reduse the pressure setpoint to increase the altitude
         // ---------------------------------------------
         else if (link_waypoint_step == LINK_STEP_ASCENT) {
+            // Decrease pressure (increase altitude) along the precalculated profile
             // Go to step WAYP_CALC as soon as the pressure waypoint is reached
-            if (pid_alt_setpoint <= ground_pressure - LINK_PRESSURE_ASCEND && actual_pressure <= pid_alt_setpoint + 10)
+            if (!trajectory_altitude_step() && actual_pressure <= pid_alt_setpoint + 10)
                 link_waypoint_step = LINK_STEP_WAYP_CALC;
-
-            // Decrease pressure (increase altitude) until waypoint is reached
-            else if (pid_alt_setpoint >= ground_pressure - LINK_PRESSURE_ASCEND)
-                pid_alt_setpoint -= WAYPOINT_ALTITUDE_TERM;
         }
 
         // ---------------------------------------------
@@ -132,39 +132,11 @@ void liberty_link_handler(void) {
 
                     // If the drone if far from the waypoint
                     else {
-                        // Reset latitude float adjustments if direction has changed
-                        if ((l_lat_waypoint > l_lat_setpoint && l_lat_waypoint_last < l_lat_setpoint) ||
-                            (l_lat_waypoint < l_lat_setpoint && l_lat_waypoint_last > l_lat_setpoint))
-                            l_lat_gps_float_adjust = 0;
-
-                        // Reset latitude float adjustments if direction has changed
-                        if ((l_lon_waypoint > l_lon_setpoint && l_lon_waypoint_last < l_lon_setpoint) ||
-                            (l_lon_waypoint < l_lon_setpoint && l_lon_waypoint_last > l_lon_setpoint))
-                            l_lon_gps_float_adjust = 0;
-
-                        // Recalculate factors if waypoint has changed
-                        if (l_lat_waypoint != l_lat_waypoint_last || l_lon_waypoint != l_lon_waypoint_last) {
-                            // Reset factors because they need to be recalculated
-                            waypoint_lat_factor = 0;
-                            waypoint_lon_factor = 0;
-
-                            // Calculate factors
-                            if (abs(l_lat_waypoint - l_lat_setpoint) >= abs(l_lon_waypoint - l_lon_setpoint)) {
-                                waypoint_lon_factor = (float)abs(l_lon_waypoint - l_lon_setpoint) / (float)abs(l_lat_waypoint - l_lat_setpoint);
-                                waypoint_lat_factor = 1;
-                            }
-                            else {
-                                waypoint_lon_factor = 1;
-                                waypoint_lat_factor = (float)abs(l_lat_waypoint - l_lat_setpoint) / (float)abs(l_lon_waypoint - l_lon_setpoint);
-                            }
-                        }
+                        // Precalculate the leg from the current setpoint to the waypoint
+                        trajectory_gps_start();
 
                         // Go to GPS waypoint flight
                         link_waypoint_step = LINK_STEP_GPS_WAYP;
-
-                        // Store new waypoints
-                        l_lat_waypoint_last = l_lat_waypoint;
-                        l_lon_waypoint_last = l_lon_waypoint;
                     }
                 }
             }
@@ -188,27 +160,10 @@ void liberty_link_handler(void) {
         // Step GPS_WAYP. GPS waypoint flight
         // ---------------------------------------------
         else if (link_waypoint_step == LINK_STEP_GPS_WAYP) {
-            // If the drone is nearby to the waypoint, go to the GPS setpoint
-            if (abs(l_lat_setpoint - l_lat_waypoint) < GPS_SETPOINT_MAX_DISTANCE
-                && abs(l_lon_setpoint - l_lon_waypoint) < GPS_SETPOINT_MAX_DISTANCE)
+            // Move the GPS setpoint along the precalculated leg
+            // Go to the GPS setpoint as soon as the end of the leg is reached
+            if (!trajectory_gps_step())
                 link_waypoint_step = LINK_STEP_GPS_SETP;
-
-            // Calculate speed factor
-            if (abs(l_lat_waypoint - l_lat_setpoint) < 160 && abs(l_lon_waypoint - l_lon_setpoint) < 160
-                && waypoint_move_factor > WAYPOINT_GPS_MIN_FACTOR)
-                waypoint_move_factor -= 0.00015;
-            else if (waypoint_move_factor < WAYPOINT_GPS_MAX_FACTOR)
-                waypoint_move_factor += 0.0001;
-
-            // Calculate adjustments
-            if (l_lat_waypoint != l_lat_setpoint) {
-                if (l_lat_waypoint > l_lat_setpoint) l_lat_gps_float_adjust += waypoint_move_factor * waypoint_lat_factor;
-                if (l_lat_waypoint < l_lat_setpoint) l_lat_gps_float_adjust -= waypoint_move_factor * waypoint_lat_factor;
-            }
-            if (l_lon_waypoint != l_lon_setpoint) {
-                if (l_lon_waypoint > l_lon_setpoint) l_lon_gps_float_adjust += waypoint_move_factor * waypoint_lon_factor;
-                if (l_lon_waypoint < l_lon_setpoint) l_lon_gps_float_adjust -= waypoint_move_factor * waypoint_lon_factor;
-            }
         }
 
         // ---------------------------------------------
@@ -218,6 +173,11 @@ void liberty_link_handler(void) {
             // Set GPS setpoint
             l_lat_setpoint = l_lat_waypoint;
             l_lon_setpoint = l_lon_waypoint;
+            l_lat_gps_float_adjust = 0;
+            l_lon_gps_float_adjust = 0;
+
+            // The setpoint is not moving anymore, so the next leg starts from zero velocity
+            trajectory_stop(TRAJECTORY_GPS);
 
             // Reset setpoint of sonarus
             pid_sonarus_setpoint = 0;
@@ -241,12 +201,12 @@ void liberty_link_handler(void) {
 
             // Switch to parsel drop or descending if waypoint command is drop a parcel or descending
             else if (waypoint_command == WAYP_CMD_BITS_PARCEL || waypoint_command == WAYP_CMD_BITS_DESCEND) {
-                link_waypoint_step = LINK_STEP_DESCENT;
+                link_start_descent();
             }
 
             // Set sonarus setpoint to SONARUS_DESCENT_MM if waypoint command is descending
             else if (waypoint_command == WAYP_CMD_BITS_DDC) {
-                link_waypoint_step = LINK_STEP_DESCENT;
+                link_start_descent();
             }
         }
 
@@ -261,8 +221,10 @@ void liberty_link_handler(void) {
             }
             
             else {
-                // Increase pressure (decrease altitude)
-                pid_alt_setpoint += WAYPOINT_ALTITUDE_TERM;
+                // Increase pressure (decrease altitude) along the precalculated profile
+                // Keep descending slowly if the ground is lower than expected
+                if (!trajectory_altitude_step())
+                    pid_alt_setpoint += WAYPOINT_ALTITUDE_CREEP_TERM;
 
                 // Reset sonarus PID controller
                 sonarus_pid_reset();
@@ -309,7 +271,7 @@ void liberty_link_handler(void) {
                     ground_pressure = actual_pressure + (float)SONARUS_DESCENT_MM / 84.2f;
 
                 // Switch to altitude incresing
-                link_waypoint_step = LINK_STEP_ASCENT;
+                link_start_ascent();
 
                 // Reset dropping servo if current command is BITS_PARCEL
                 if (waypoint_command == WAYP_CMD_BITS_PARCEL)
@@ -344,10 +306,35 @@ void link_begin_sequence(void) {
     // Start from beggining of the waypoints array
     waypoints_index = 0;
 
+    // Start the first leg from zero velocity
+    trajectory_stop(TRAJECTORY_GPS);
+
     // Reset takeoff flag
     link_takeoff_flag = 0;
 }
 
+/// <summary>
+/// Precalculates altitude profile and switches to the ASCENT step
+/// </summary>
+void link_start_ascent(void) {
+    // Ascend only if the setpoint is below the required altitude
+    if (pid_alt_setpoint > ground_pressure - LINK_PRESSURE_ASCEND)
+        trajectory_altitude_start(ground_pressure - LINK_PRESSURE_ASCEND);
+    else
+        trajectory_altitude_start(pid_alt_setpoint);
+
+    link_waypoint_step = LINK_STEP_ASCENT;
+}
+
+/// <summary>
+/// Precalculates altitude profile to the ground pressure and switches to the DESCENT step
+/// </summary>
+void link_start_descent(void) {
+    trajectory_altitude_start(ground_pressure);
+
+    link_waypoint_step = LINK_STEP_DESCENT;
+}
+
 /// <summary>
 /// Clears array of waypoints and some other variables 
 /// when the motors are turning off
@@ -407,8 +394,18 @@ void direct_control_abort(void) {
     // Reset GPS corrections
     l_lat_gps_float_adjust = 0;
     l_lon_gps_float_adjust = 0;
-    waypoint_move_factor = 0;
     pid_gps_reset();
+
+    // Recalculate the leg from the new setpoint (and zero velocity) if in GPS waypoint flight
+    trajectory_stop(TRAJECTORY_GPS);
+    if (link_waypoint_step == LINK_STEP_GPS_WAYP)
+        link_waypoint_step = LINK_STEP_WAYP_CALC;
+
+    // Recalculate altitude profile from the new pressure setpoint, so the profile doesn't cancel the climb
+    if (link_waypoint_step == LINK_STEP_ASCENT)
+        link_start_ascent();
+    else if (link_waypoint_step == LINK_STEP_DESCENT)
+        link_start_descent();
 }
 
 /// <summary>
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2022 Fern Lane, Liberty-X Flight controller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * The Liberty-X project started as a fork of the YMFC-32 project by Joop Brokking
+ *
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * IT IS STRICTLY PROHIBITED TO USE THE PROJECT (OR PARTS OF THE PROJECT / CODE)
+ * FOR MILITARY PURPOSES. ALSO, IT IS STRICTLY PROHIBITED TO USE THE PROJECT (OR PARTS OF THE PROJECT / CODE)
+ * FOR ANY PURPOSE THAT MAY LEAD TO INJURY, HUMAN, ANIMAL OR ENVIRONMENTAL DAMAGE.
+ * ALSO, IT IS PROHIBITED TO USE THE PROJECT (OR PARTS OF THE PROJECT / CODE) FOR ANY PURPOSE THAT
+ * VIOLATES INTERNATIONAL HUMAN RIGHTS OR HUMAN FREEDOM.
+ * BY USING THE PROJECT (OR PART OF THE PROJECT / CODE) YOU AGREE TO ALL OF THE ABOVE RULES.
+ */
+
+#ifdef MEMORY_MONITOR
+
+// End of the heap (provided by the core)
+extern "C" char *sbrk(int incr);
+
+/// <summary>
+/// Records static RAM usage and fills free RAM between the heap and the stack with MEMORY_PAINT_PATTERN
+/// Must be called first in setup() while the stack is still shallow
+/// </summary>
+void memory_setup(void) {
+	// Address of this variable is the current stack frame
+	uint8_t stack_marker;
+
+	// Everything below the heap is .data and .bss
+	memory_heap_start = (uint32_t)sbrk(0);
+	memory_static_ram = memory_heap_start - SRAM_START;
+
+	// Paint from the heap (plus margin for future allocations) to the current stack frame
+	memory_paint_start = (uint32_t *)((memory_heap_start + MEMORY_HEAP_MARGIN + 3) & ~3UL);
+	memory_stack_lowest = (uint32_t *)(((uint32_t)&stack_marker - 64) & ~3UL);
+	for (memory_temp_pointer = memory_paint_start; memory_temp_pointer < memory_stack_lowest; memory_temp_pointer++)
+		*memory_temp_pointer = MEMORY_PAINT_PATTERN;
+
+	// Start the first scan from the bottom of the painted area
+	memory_scan_pointer = memory_paint_start;
+
+	memory_check();
+}
+
+/// <summary>
+/// Moves the stack high-water mark down to the lowest overwritten paint and calculates memory usage
+/// The painted area is scanned upwards from the bottom, MEMORY_SCAN_WORDS per call,
+/// so unwritten words inside the stack (padding, uninitialized locals) can't hide deeper usage
+/// </summary>
+void memory_check(void) {
+	// Dynamic memory
+	memory_heap_end = (uint32_t)sbrk(0);
+	memory_heap_used = memory_heap_end - memory_heap_start;
+
+	// Don't count the heap that has grown into the painted area as stack
+	if ((uint32_t)memory_scan_pointer < memory_heap_end)
+		memory_scan_pointer = (uint32_t *)((memory_heap_end + 3) & ~3UL);
+
+	for (memory_scan_counter = 0; memory_scan_counter < MEMORY_SCAN_WORDS; memory_scan_counter++) {
+		// Nothing below the current high-water mark is touched. Start the next pass from the bottom
+		if (memory_scan_pointer >= memory_stack_lowest) {
+			memory_scan_pointer = memory_paint_start;
+			break;
+		}
+
+		// The lowest overwritten word is the new high-water mark. Start the next pass from the bottom
+		if (*memory_scan_pointer != MEMORY_PAINT_PATTERN) {
+			memory_stack_lowest = memory_scan_pointer;
+			memory_scan_pointer = memory_paint_start;
+			break;
+		}
+
+		memory_scan_pointer++;
+	}
+
+	// Maximum stack usage
+	memory_stack_used = SRAM_END - (uint32_t)memory_stack_lowest;
+
+	// Free RAM between the heap and the deepest stack usage
+	if ((uint32_t)memory_stack_lowest > memory_heap_end)
+		memory_free = (uint32_t)memory_stack_lowest - memory_heap_end;
+	else
+		memory_free = 0;
+}
+
+#endif
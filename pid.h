@@ -93,6 +93,11 @@ const float PID_ALT_D PROGMEM = 14.0;
 // Maximum output of the PID - controller (+ / -)
 const float PID_ALT_MAX PROGMEM = 200;
 
+#ifdef LIBERTY_LINK
+// Altitude trajectory velocity feed-forward (default = 400)
+const float PID_ALT_FF PROGMEM = 400;
+#endif
+
 
 /*****************************/
 /*            GPS            */
@@ -106,6 +111,11 @@ const float PID_GPS_D PROGMEM = 7.6f;
 // Maximum output of the PID - controller (+ / -)
 const float PID_GPS_MAX PROGMEM = 300;
 
+#ifdef LIBERTY_LINK
+// GPS trajectory velocity feed-forward (default = 500)
+const float PID_GPS_FF PROGMEM = 500;
+#endif
+
 
 #if (defined(SONARUS) && defined(LIBERTY_LINK))
 /*********************************/
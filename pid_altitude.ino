@@ -73,6 +73,11 @@ void pid_altitude(void) {
 	// Calculate output of the PID-controller
 	pid_output_alt = (PID_ALT_P + pid_error_gain_altitude) * pid_error_temp + pid_i_mem_alt + alt_total_avarage * PID_ALT_D;
 
+#ifdef LIBERTY_LINK
+	// Add velocity feed-forward from the trajectory generator
+	pid_output_alt -= trajectory_alt_velocity * PID_ALT_FF;
+#endif
+
 	// Clip PID output
 	if (pid_output_alt > PID_ALT_MAX) pid_output_alt = PID_ALT_MAX;
 	else if (pid_output_alt < PID_ALT_MAX * -1) pid_output_alt = PID_ALT_MAX * -1;
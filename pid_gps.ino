@@ -63,6 +63,12 @@ void pid_gps(void) {
 	pid_output_gps_lat = (float)gps_lat_error * PID_GPS_P + (float)gps_lat_total_avarage * PID_GPS_D;
 	pid_output_gps_lon = (float)gps_lon_error * PID_GPS_P + (float)gps_lon_total_avarage * PID_GPS_D;
 
+#ifdef LIBERTY_LINK
+	// Add velocity feed-forward from the trajectory generator
+	pid_output_gps_lat -= trajectory_lat_velocity * PID_GPS_FF;
+	pid_output_gps_lon += trajectory_lon_velocity * PID_GPS_FF;
+#endif
+
 	// Because the correction is calculated as if the nose was facing north, we need to convert it for the current heading
 	gps_pitch_adjust = ((float)pid_output_gps_lat * cos(angle_yaw * DEG_TO_RAD)) + ((float)pid_output_gps_lon * cos((angle_yaw + 90) * DEG_TO_RAD));
 	gps_roll_adjust = ((float)pid_output_gps_lon * cos(angle_yaw * DEG_TO_RAD)) + ((float)pid_output_gps_lat * cos((angle_yaw - 90) * DEG_TO_RAD));
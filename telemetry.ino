@@ -214,16 +214,66 @@ void telemetry(void) {
 		telemetry_send_byte = 0;
 #endif
 
+#if defined(MEMORY_MONITOR) && defined(TELEMETRY_MEMORY_REPORT)
+	else if (telemetry_loop_counter == 32) {
+		// Store the stack high-water mark as it can change during the next loop
+		telemetry_buffer_bytes = memory_stack_used;
+
+		// Send the first 8 bytes of the stack usage
+		telemetry_send_byte = telemetry_buffer_bytes >> 8;
+	}
+
+	// Send the last 8 bytes of the stack usage
+	else if (telemetry_loop_counter == 33)
+		telemetry_send_byte = telemetry_buffer_bytes;
+
+	else if (telemetry_loop_counter == 34) {
+		// Store the free RAM as it can change during the next loop
+		telemetry_buffer_bytes = memory_free;
+
+		// Send the first 8 bytes of the free RAM
+		telemetry_send_byte = telemetry_buffer_bytes >> 8;
+	}
+
+	// Send the last 8 bytes of the free RAM
+	else if (telemetry_loop_counter == 35)
+		telemetry_send_byte = telemetry_buffer_bytes;
+
+	else if (telemetry_loop_counter == 36) {
+		// Store the heap usage as it can change during the next loop
+		telemetry_buffer_bytes = memory_heap_used;
+
+		// Send the first 8 bytes of the heap usage
+		telemetry_send_byte = telemetry_buffer_bytes >> 8;
+	}
+
+	// Send the last 8 bytes of the heap usage
+	else if (telemetry_loop_counter == 37)
+		telemetry_send_byte = telemetry_buffer_bytes;
+
+	else if (telemetry_loop_counter == 38) {
+		// Store the static RAM usage (.data and .bss)
+		telemetry_buffer_bytes = memory_static_ram;
+
+		// Send the first 8 bytes of the static RAM usage
+		telemetry_send_byte = telemetry_buffer_bytes >> 8;
+	}
+
+	// Send the last 8 bytes of the static RAM usage
+	else if (telemetry_loop_counter == 39)
+		telemetry_send_byte = telemetry_buffer_bytes;
+#endif
+
 	// Send the check-byte
-	else if (telemetry_loop_counter == 32)telemetry_send_byte = telemetry_check_byte;
+	else if (telemetry_loop_counter == TELEMETRY_CHECK_BYTE_N)telemetry_send_byte = telemetry_check_byte;
 
 	// Send the first suffix
-	else if (telemetry_loop_counter == 33)telemetry_send_byte = TELEMETRY_SUFFIX_1;
+	else if (telemetry_loop_counter == TELEMETRY_CHECK_BYTE_N + 1)telemetry_send_byte = TELEMETRY_SUFFIX_1;
 
 	// Send the second suffix
-	else if (telemetry_loop_counter == 34)telemetry_send_byte = TELEMETRY_SUFFIX_2;
+	else if (telemetry_loop_counter == TELEMETRY_CHECK_BYTE_N + 2)telemetry_send_byte = TELEMETRY_SUFFIX_2;
 
-	if (telemetry_loop_counter > 0 && telemetry_loop_counter <= 34) {
+	if (telemetry_loop_counter > 0 && telemetry_loop_counter <= TELEMETRY_CHECK_BYTE_N + 2) {
 		// XOR every send_byte
 		telemetry_check_byte ^= telemetry_send_byte;
 
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2022 Fern Lane, Liberty-X Flight controller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * The Liberty-X project started as a fork of the YMFC-32 project by Joop Brokking
+ *
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * IT IS STRICTLY PROHIBITED TO USE THE PROJECT (OR PARTS OF THE PROJECT / CODE)
+ * FOR MILITARY PURPOSES. ALSO, IT IS STRICTLY PROHIBITED TO USE THE PROJECT (OR PARTS OF THE PROJECT / CODE)
+ * FOR ANY PURPOSE THAT MAY LEAD TO INJURY, HUMAN, ANIMAL OR ENVIRONMENTAL DAMAGE.
+ * ALSO, IT IS PROHIBITED TO USE THE PROJECT (OR PARTS OF THE PROJECT / CODE) FOR ANY PURPOSE THAT
+ * VIOLATES INTERNATIONAL HUMAN RIGHTS OR HUMAN FREEDOM.
+ * BY USING THE PROJECT (OR PART OF THE PROJECT / CODE) YOU AGREE TO ALL OF THE ABOVE RULES.
+ */
+
+/*
+ * Host test of the MS5611 pressure calculation in barometer.ino
+ *
+ * Compares barometer_compensate_temperature() + step 2 of barometer_handler() with the original formula
+ * P = ((raw_pressure * SENS) / 2097152UL - OFF) / 32768UL over random calibration and raw values
+ * Second order compensation is disabled, because the original formula has only the first order
+ *
+ * Build and run (from this directory):
+ *     g++ -O2 -o barometer_test barometer_test.cpp && ./barometer_test [cases]
+ *
+ * Note: on the STM32 unsigned long is 32-bit, so the divisors are signed-promoted to int64_t.
+ * On a 64-bit host UL would make the division unsigned, so the reference uses (uint32_t) divisors
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <random>
+
+#define PROGMEM
+typedef uint8_t boolean;
+
+/// <summary>
+/// I2C stand-in. Never used by the pressure calculation
+/// </summary>
+class MockWire {
+public:
+	void beginTransmission(uint8_t) {}
+	uint8_t endTransmission(void) { return 0; }
+	void write(uint8_t) {}
+	void requestFrom(uint8_t, uint8_t) {}
+	uint8_t read(void) { return 0; }
+} HWire;
+
+void leds_error_signal(void) {}
+void leds_calibration_signal(void) {}
+void delayMicroseconds(uint32_t) {}
+void pid_altitude_reset(void) {}
+
+// Functions defined in barometer.ino (Arduino generates these prototypes)
+void barometer_handler(void);
+void barometer_compensate_temperature(void);
+int64_t barometer_div_pow2(int64_t value, uint8_t shift);
+
+// Sketch configuration and state (first order compensation only)
+#include "../../config.h"
+#undef BAROMETER_SECOND_ORDER
+#include "../../constants.h"
+#include "../../pid.h"
+#include "../../datatypes.h"
+
+// Sketch code under test
+#include "../../barometer.ino"
+
+int main(int argc, char **argv) {
+	uint64_t cases = argc > 1 ? strtoull(argv[1], NULL, 10) : 20000000ULL;
+	uint64_t mismatches = 0;
+	std::mt19937_64 random(1);
+
+	for (uint64_t i = 0; i < cases; i++) {
+		// Random calibration values (the same as barometer_setup())
+		for (int j = 1; j <= 6; j++)
+			C[j] = (uint16_t)random();
+		OFF_C2 = C[2] * (int64_t)65536;
+		SENS_C1 = C[1] * (int64_t)32768;
+
+		// Random 24-bit raw values
+		raw_temperature = random() & 0xFFFFFF;
+		raw_pressure = random() & 0xFFFFFF;
+
+		// Reference: original calculation with 32-bit unsigned long divisors
+		int32_t dT_reference = C[5];
+		dT_reference <<= 8;
+		dT_reference *= -1;
+		dT_reference += raw_temperature;
+		int64_t OFF_reference = OFF_C2 + ((int64_t)dT_reference * (int64_t)C[4]) / 128LL;
+		int64_t SENS_reference = SENS_C1 + ((int64_t)dT_reference * (int64_t)C[3]) / 256LL;
+		int64_t P_reference = ((raw_pressure * SENS_reference) / (uint32_t)2097152 - OFF_reference) / (uint32_t)32768;
+
+		// Tested: cached compensation and step 2 of the handler
+		barometer_compensate_temperature();
+		barometer_counter = 1;
+		barometer_handler();
+
+		if (P != P_reference || OFF != OFF_reference || SENS != SENS_reference) {
+			if (mismatches < 10)
+				printf("Mismatch: C = %u %u %u %u %u %u, D1 = %u, D2 = %u, P = %lld, expected %lld\n",
+					C[1], C[2], C[3], C[4], C[5], C[6], raw_pressure, raw_temperature,
+					(long long)P, (long long)P_reference);
+			mismatches++;
+		}
+	}
+
+	printf("%llu cases, %llu mismatches\n", (unsigned long long)cases, (unsigned long long)mismatches);
+	return mismatches ? 1 : 0;
+}
@@ -0,0 +1,196 @@
+"""
+Copyright (C) 2022 Fern Lane, Liberty-X Flight controller
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Host side of the Liberty-X debugger (debugger.ino)
+Lists the variable registry, selects variables and sample rate and dumps samples as CSV
+
+Usage:
+    python debugger_scope.py PORT --list
+    python debugger_scope.py PORT angle_roll angle_pitch pid_output_roll --divider 1 --csv out.csv
+
+Requires pyserial (pip install pyserial)
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+import serial
+
+# Must match config.h and constants.h
+SUFFIX_1 = 0xEE
+SUFFIX_2 = 0xEF
+CHANNELS_MAX = 8
+
+CMD_LIST = 1
+CMD_SELECT = 2
+
+FRAME_VARIABLE = 1
+FRAME_SAMPLE = 2
+
+# DEBUG_TYPE_... -> (name, struct format)
+TYPES = {
+    0: ("uint8", "<B"),
+    1: ("int8", "<b"),
+    2: ("uint16", "<H"),
+    3: ("int16", "<h"),
+    4: ("uint32", "<I"),
+    5: ("int32", "<i"),
+    6: ("float", "<f"),
+}
+
+# Loop period of the flight controller in seconds
+LOOP_PERIOD = 0.004
+
+
+def send_command(port, command, divider=0, channels=()):
+    """
+    Sends host -> FC frame: CMD, DIVIDER, 8 x CHANNEL, CHECK, SUFFIX_1, SUFFIX_2
+    """
+    payload = [command, divider] + list(channels) + [0xFF] * (CHANNELS_MAX - len(channels))
+    check = 0
+    for byte in payload:
+        check ^= byte
+    port.write(bytes(payload + [check, SUFFIX_1, SUFFIX_2]))
+
+
+def read_frames(port):
+    """
+    Yields (type, payload) of valid FC -> host frames: SUFFIX_1, SUFFIX_2, TYPE, LENGTH, PAYLOAD, CHECK
+    Bytes outside of the frames (for example calibration prints) are skipped
+    Yields (None, b"") on read timeout
+    """
+    buffer = bytearray()
+    while True:
+        data = port.read(max(1, port.in_waiting))
+        if not data:
+            yield None, b""
+            continue
+        buffer += data
+        while True:
+            start = buffer.find(bytes([SUFFIX_1, SUFFIX_2]))
+            if start < 0:
+                del buffer[:-1]
+                break
+            if len(buffer) < start + 4:
+                del buffer[:start]
+                break
+            frame_type, length = buffer[start + 2], buffer[start + 3]
+            end = start + 4 + length + 1
+            if len(buffer) < end:
+                del buffer[:start]
+                break
+            check = 0
+            for byte in buffer[start + 2:end - 1]:
+                check ^= byte
+            if check == buffer[end - 1]:
+                yield frame_type, bytes(buffer[start + 4:end - 1])
+                del buffer[:end]
+            else:
+                # Not a frame, look for the next sync bytes
+                del buffer[:start + 1]
+
+
+def read_registry(port, timeout=5.0):
+    """
+    Requests and returns the variable registry as {index: (name, type)}
+    """
+    send_command(port, CMD_LIST)
+    registry = {}
+    port.timeout = 0.2
+    time_start = time.time()
+    for frame_type, payload in read_frames(port):
+        if frame_type == FRAME_VARIABLE:
+            registry[payload[0]] = (payload[2:].decode("ascii", "replace"), payload[1])
+            time_start = time.time()
+        if registry and time.time() - time_start > 0.5 or time.time() - time_start > timeout:
+            break
+    return registry
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Liberty-X debugger scope")
+    parser.add_argument("port", help="Serial port of the flight controller (DEBUG_SERIAL)")
+    parser.add_argument("variables", nargs="*", help="Names of the variables to stream")
+    parser.add_argument("--baudrate", type=int, default=115200, help="DEBUGGER_BAUDRATE")
+    parser.add_argument("--divider", type=int, default=1, help="Sample every N loops (1 = 250Hz)")
+    parser.add_argument("--list", action="store_true", help="Print the variable registry and exit")
+    parser.add_argument("--csv", help="Write samples to this file instead of stdout")
+    args = parser.parse_args()
+
+    port = serial.Serial(args.port, args.baudrate, timeout=0.2)
+
+    registry = read_registry(port)
+    if not registry:
+        sys.exit("No answer from the flight controller. Is DEBUGGER enabled?")
+
+    if args.list or not args.variables:
+        for index in sorted(registry):
+            name, var_type = registry[index]
+            print("{0:3d}  {1:8s}  {2}".format(index, TYPES[var_type][0], name))
+        return
+
+    if len(args.variables) > CHANNELS_MAX:
+        sys.exit("Maximum {0} variables can be selected".format(CHANNELS_MAX))
+
+    names = {name: index for index, (name, _) in registry.items()}
+    for name in args.variables:
+        if name not in names:
+            sys.exit("Unknown variable: " + name)
+    channels = [names[name] for name in args.variables]
+    formats = [TYPES[registry[index][1]][1] for index in channels]
+
+    output = open(args.csv, "w") if args.csv else sys.stdout
+    output.write(",".join(["time", "sample"] + args.variables) + "\n")
+
+    send_command(port, CMD_SELECT, max(1, min(args.divider, 255)), channels)
+
+    sample_previous = None
+    sample_offset = 0
+    lost = 0
+    try:
+        for frame_type, payload in read_frames(port):
+            if frame_type != FRAME_SAMPLE:
+                continue
+
+            # 16-bit sample counter -> continuous counter
+            sample = struct.unpack_from("<H", payload)[0]
+            if sample_previous is not None:
+                if sample < sample_previous:
+                    sample_offset += 65536
+                lost += max(0, (sample - sample_previous) % 65536 - 1)
+            sample_previous = sample
+            sample += sample_offset
+
+            position = 2
+            values = []
+            for value_format in formats:
+                values.append(struct.unpack_from(value_format, payload, position)[0])
+                position += struct.calcsize(value_format)
+
+            output.write("{0:.3f},{1},".format(sample * args.divider * LOOP_PERIOD, sample)
+                         + ",".join(str(value) for value in values) + "\n")
+    except KeyboardInterrupt:
+        pass
+    finally:
+        # Stop streaming
+        send_command(port, CMD_SELECT, 1, [])
+        if output is not sys.stdout:
+            output.close()
+        print("Lost samples: {0}".format(lost), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
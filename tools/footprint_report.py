@@ -0,0 +1,226 @@
+"""
+Copyright (C) 2022 Fern Lane, Liberty-X Flight controller
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Per-module RAM / flash footprint report from the GNU ld map file
+
+The map file is written to the Arduino build folder (Liberty-X.ino.map) when the sketch is compiled
+with verbose output enabled. If it is missing, add -Wl,-Map,{build.path}/{build.project_name}.map
+to the linker recipe (compiler.c.elf.extra_flags)
+
+Sketch functions are assigned to the .ino file that defines them,
+sketch variables to the section of datatypes.h that declares them (// Barometer, // GPS, ...)
+Everything else is grouped by library / core object
+
+Usage:
+    python footprint_report.py Liberty-X.ino.map [--sketch ..] [--symbols]
+"""
+
+import argparse
+import glob
+import os
+import re
+from collections import defaultdict
+
+# STM32F103 with 128KB flash (EEPROM.PageBase0 = 0x801F000 in Liberty-X.ino assumes it)
+FLASH_SIZE = 128 * 1024
+RAM_SIZE = 20 * 1024
+
+# EEPROM emulation pages at 0x801F000 - 0x801FFFF can't be used for the code
+EEPROM_SIZE = 4 * 1024
+
+# Input section line (name may be on its own line if it is too long)
+SECTION_RE = re.compile(r"^ (\.[\w.$]+|COMMON)(?:\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(.+))?$")
+SECTION_CONTINUATION_RE = re.compile(r"^\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(.+)$")
+
+# Input sections stored in flash (.ARM.attributes is not loaded, so it is not counted)
+FLASH_KINDS = ("text", "rodata", "ARM.exidx", "ARM.extab", "isr_vector", "stm32.interrupt_vector",
+               "init_array", "fini_array")
+
+# Section kinds with two-part names
+COMPOUND_KINDS = ("ARM.exidx", "ARM.extab", "ARM.attributes", "stm32.interrupt_vector")
+
+# Function definition in .ino files
+FUNCTION_RE = re.compile(r"^\w[\w\s\*]*?\b(\w+)\s*\([^;]*\)\s*\{?\s*$")
+
+# Variable declaration in datatypes.h
+VARIABLE_RE = re.compile(r"\b([A-Za-z_]\w*)\s*(?:\[[^\]]*\])?\s*(?:=[^,;]*)?(?=[,;])")
+
+
+def demangle(name):
+    """
+    Returns the plain function name from the C++ mangled name (_Z16barometer_handlerv -> barometer_handler)
+    """
+    match = re.match(r"_Z(\d+)(\w+)", name)
+    if match:
+        return match.group(2)[:int(match.group(1))]
+    return name
+
+
+def section_kind(name):
+    """
+    Returns section kind and symbol name of the input section (.text._Z...v -> text, _Z...v,
+    .ARM.exidx.text._Z...v -> ARM.exidx, _Z...v)
+    """
+    if not name.startswith("."):
+        return "bss", ""
+    name = name[1:]
+    for kind in COMPOUND_KINDS:
+        if name == kind or name.startswith(kind + "."):
+            symbol = name[len(kind) + 1:]
+            if "." in symbol:
+                symbol = symbol.split(".", 1)[1]
+            return kind, symbol
+    kind, _, symbol = name.partition(".")
+    return kind, symbol
+
+
+def read_sketch(sketch_path):
+    """
+    Returns {function: ino file} and {variable: datatypes.h section}
+    """
+    functions = {}
+    for ino_file in glob.glob(os.path.join(sketch_path, "*.ino")):
+        module = os.path.basename(ino_file)
+        with open(ino_file, encoding="utf-8", errors="replace") as file:
+            for line in file:
+                match = FUNCTION_RE.match(line)
+                if match and not line.startswith((" ", "\t")):
+                    functions[match.group(1)] = module
+
+    variables = {}
+    datatypes_file = os.path.join(sketch_path, "datatypes.h")
+    if os.path.exists(datatypes_file):
+        section = "datatypes.h"
+        with open(datatypes_file, encoding="utf-8", errors="replace") as file:
+            for line in file:
+                line = line.strip()
+                if line.startswith("//"):
+                    section = "datatypes.h: " + line[2:].strip()
+                elif line and not line.startswith("#") and (";" in line or "," in line):
+                    # Skip the type name
+                    declaration = line.split(None, 1)[1] if " " in line else ""
+                    for match in VARIABLE_RE.finditer(declaration):
+                        variables[match.group(1)] = section
+    return functions, variables
+
+
+def read_map(map_file):
+    """
+    Yields (section, symbol, size, object) for each input section of the memory map
+    """
+    with open(map_file, encoding="utf-8", errors="replace") as file:
+        lines = file.read().splitlines()
+
+    # Only the memory map part contains addresses
+    start = 0
+    for index, line in enumerate(lines):
+        if line.startswith("Linker script and memory map"):
+            start = index
+            break
+
+    index = start
+    while index < len(lines):
+        match = SECTION_RE.match(lines[index])
+        index += 1
+        if not match:
+            continue
+        name, size, obj = match.group(1), match.group(3), match.group(4)
+        if size is None:
+            if index >= len(lines):
+                break
+            continuation = SECTION_CONTINUATION_RE.match(lines[index])
+            if not continuation:
+                continue
+            size, obj = continuation.group(2), continuation.group(3)
+            index += 1
+        size = int(size, 16)
+        if size == 0:
+            continue
+
+        # .bss.name / .text._Z...
+        kind, symbol = section_kind(name)
+        yield kind, demangle(symbol), size, obj.strip()
+
+
+def module_of(symbol, obj, functions, variables):
+    """
+    Returns module name for the symbol
+    """
+    base = os.path.basename(obj.split("(")[0])
+    if base.startswith("Liberty-X.ino"):
+        if symbol in functions:
+            return functions[symbol]
+        if symbol in variables:
+            return variables[symbol]
+        return "sketch (other)"
+    path = obj.replace("\\", "/")
+    match = re.search(r"/libraries/([^/]+)/", path)
+    if match:
+        return "library: " + match.group(1)
+    if "/core/" in path or base.startswith("core"):
+        return "core: " + base
+    return base
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Liberty-X RAM / flash footprint report")
+    parser.add_argument("map", help="Linker map file (Liberty-X.ino.map)")
+    parser.add_argument("--sketch", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."),
+                        help="Sketch folder (default: repository root)")
+    parser.add_argument("--flash-size", type=int, default=FLASH_SIZE, help="Flash size in bytes (default: 128KB)")
+    parser.add_argument("--eeprom-size", type=int, default=EEPROM_SIZE,
+                        help="Flash reserved for the EEPROM emulation in bytes (default: 4KB)")
+    parser.add_argument("--symbols", action="store_true", help="Print the largest RAM symbols")
+    args = parser.parse_args()
+
+    functions, variables = read_sketch(args.sketch)
+
+    flash = defaultdict(int)
+    ram = defaultdict(int)
+    ram_symbols = []
+    for kind, symbol, size, obj in read_map(args.map):
+        module = module_of(symbol, obj, functions, variables)
+        if kind in FLASH_KINDS:
+            flash[module] += size
+        elif kind == "data":
+            # Initialized data is stored in flash and copied to RAM
+            flash[module] += size
+            ram[module] += size
+            ram_symbols.append((size, symbol, module))
+        elif kind in ("bss", "COMMON", "noinit"):
+            ram[module] += size
+            ram_symbols.append((size, symbol, module))
+
+    modules = sorted(set(flash) | set(ram), key=lambda name: (-ram[name], -flash[name]))
+    print("{0:<40s} {1:>8s} {2:>8s}".format("Module", "Flash", "RAM"))
+    for module in modules:
+        print("{0:<40s} {1:>8d} {2:>8d}".format(module[:40], flash[module], ram[module]))
+
+    flash_total, ram_total = sum(flash.values()), sum(ram.values())
+    print()
+    flash_available = args.flash_size - args.eeprom_size
+    print("Flash: {0} of {1} bytes ({2:.1f}%), {3} bytes reserved for EEPROM".format(
+        flash_total, flash_available, 100. * flash_total / flash_available, args.eeprom_size))
+    print("Static RAM: {0} of {1} bytes ({2:.1f}%), {3} bytes left for heap and stack".format(
+        ram_total, RAM_SIZE, 100. * ram_total / RAM_SIZE, RAM_SIZE - ram_total))
+
+    if args.symbols:
+        print()
+        print("Largest RAM symbols:")
+        for size, symbol, module in sorted(ram_symbols, reverse=True)[:25]:
+            print("{0:>8d}  {1:<32s} {2}".format(size, symbol, module))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2022 Fern Lane, Liberty-X Flight controller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * The Liberty-X project started as a fork of the YMFC-32 project by Joop Brokking
+ *
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * IT IS STRICTLY PROHIBITED TO USE THE PROJECT (OR PARTS OF THE PROJECT / CODE)
+ * FOR MILITARY PURPOSES. ALSO, IT IS STRICTLY PROHIBITED TO USE THE PROJECT (OR PARTS OF THE PROJECT / CODE)
+ * FOR ANY PURPOSE THAT MAY LEAD TO INJURY, HUMAN, ANIMAL OR ENVIRONMENTAL DAMAGE.
+ * ALSO, IT IS PROHIBITED TO USE THE PROJECT (OR PARTS OF THE PROJECT / CODE) FOR ANY PURPOSE THAT
+ * VIOLATES INTERNATIONAL HUMAN RIGHTS OR HUMAN FREEDOM.
+ * BY USING THE PROJECT (OR PART OF THE PROJECT / CODE) YOU AGREE TO ALL OF THE ABOVE RULES.
+ */
+
+/*
+ * Minimal Arduino / libmaple stand-in for building the Liberty-Link parser and handler on the host
+ * Only what liberty_link_parser.ino, liberty_link_handler.ino, trajectory.ino and pid_gps.ino use
+ */
+
+#ifndef ARDUINO_MOCK_H
+#define ARDUINO_MOCK_H
+
+// Standard headers must be included before the Arduino-style abs() macro
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define PROGMEM
+#define DEG_TO_RAD		0.017453292519943295769236907684886
+#define RAD_TO_DEG		57.295779513082320876798154814105
+#define abs(x)			((x) > 0 ? (x) : -(x))
+
+typedef uint8_t boolean;
+
+/// <summary>
+/// UART stand-in with a limited RX buffer (bytes are dropped on overflow like in the real core)
+/// </summary>
+class MockSerial {
+public:
+	std::deque<uint8_t> rx;
+	size_t rx_capacity = 64;
+	uint64_t rx_overflow = 0, tx_bytes = 0, read_bytes = 0;
+
+	void begin(uint32_t) {}
+	void flush(void) {}
+	int available(void) { return (int)rx.size(); }
+	int read(void);
+	size_t write(uint8_t) { tx_bytes++; return 1; }
+
+	/// <summary>
+	/// Puts the byte to the RX buffer (called by the generator instead of the UART interrupt)
+	/// </summary>
+	void receive(uint8_t data) {
+		if (rx.size() >= rx_capacity)
+			rx_overflow++;
+		else
+			rx.push_back(data);
+	}
+};
+
+extern MockSerial Serial1, Serial2;
+
+// Motor and gimbal timers (used by liberty_x_fts)
+struct MockTimer { uint32_t CCR1, CCR2, CCR3, CCR4, CNT; };
+extern MockTimer mock_timer_3, mock_timer_4;
+#define TIMER3_BASE		(&mock_timer_3)
+#define TIMER4_BASE		(&mock_timer_4)
+
+// liberty_x_fts() never returns on the real hardware, the mock leds_error_signal() throws this instead
+struct MockFtsTriggered {};
+void leds_error_signal(void);
+void delayMicroseconds(uint32_t);
+
+// Functions defined in other translation units of the sketch (Arduino generates these prototypes)
+void link_start_and_takeoff(void);
+void link_check_and_turnoff_motors(void);
+void link_begin_sequence(void);
+void link_start_ascent(void);
+void link_start_descent(void);
+void link_clear_disarm(void);
+void direct_control_abort(void);
+void liberty_x_fts(void);
+void trajectory_start(uint8_t axis, float distance, float velocity_initial, float velocity_max, float acceleration);
+void trajectory_stop(uint8_t axis);
+boolean trajectory_step(uint8_t axis);
+void trajectory_gps_start(void);
+boolean trajectory_gps_step(void);
+void trajectory_altitude_start(float pressure_target);
+boolean trajectory_altitude_step(void);
+void trajectory_reset_feed_forward(void);
+void pid_gps_reset(void);
+void sonarus_pid(void);
+void sonarus_pid_reset(void);
+
+#endif
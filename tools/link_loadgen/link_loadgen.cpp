@@ -0,0 +1,442 @@
+/*
+ * Copyright (C) 2022 Fern Lane, Liberty-X Flight controller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * The Liberty-X project started as a fork of the YMFC-32 project by Joop Brokking
+ *
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * IT IS STRICTLY PROHIBITED TO USE THE PROJECT (OR PARTS OF THE PROJECT / CODE)
+ * FOR MILITARY PURPOSES. ALSO, IT IS STRICTLY PROHIBITED TO USE THE PROJECT (OR PARTS OF THE PROJECT / CODE)
+ * FOR ANY PURPOSE THAT MAY LEAD TO INJURY, HUMAN, ANIMAL OR ENVIRONMENTAL DAMAGE.
+ * ALSO, IT IS PROHIBITED TO USE THE PROJECT (OR PARTS OF THE PROJECT / CODE) FOR ANY PURPOSE THAT
+ * VIOLATES INTERNATIONAL HUMAN RIGHTS OR HUMAN FREEDOM.
+ * BY USING THE PROJECT (OR PART OF THE PROJECT / CODE) YOU AGREE TO ALL OF THE ABOVE RULES.
+ */
+
+/*
+ * Liberty-Link ground station stand-in and load generator
+ *
+ * Builds the real liberty_link_parser() and liberty_link_handler() on the host, feeds them generated
+ * DDC, waypoint, takeoff, land and FTS packets through a mock TELEMETRY_SERIAL and reports
+ * parsed-frame throughput, per-call parse time, waypoint step latency and GPS setpoint progress
+ *
+ * Waypoint step latency is the number of loops from sending a waypoint update until the GPS setpoint starts
+ * moving towards the new waypoint (or the handler reaches LINK_STEP_GPS_SETP). Updates picked up by the handler
+ * but superseded by the next one before the setpoint moved are reported as stalled
+ *
+ * Build (from this directory):
+ *     g++ -O2 -o link_loadgen link_loadgen.cpp
+ *
+ * Usage:
+ *     ./link_loadgen [options]
+ *     --seconds N          simulated flight time (default 60)
+ *     --rate N             DDC packets per second (default 50)
+ *     --waypoint-rate N    waypoint updates per second (default 5)
+ *     --jitter N           packet interval jitter, 0..1 of the interval (default 0.2)
+ *     --ber N              bit error rate (default 0)
+ *     --partial N          probability of a truncated packet (default 0)
+ *     --noise N            random garbage bytes per second (default 0)
+ *     --baudrate N         UART baud rate (default TELEMETRY_BAUDRATE)
+ *     --rx-buffer N        UART RX buffer size in bytes (default 64)
+ *     --script FILE        scripted packets, one per line: <time_s> <packet> [args]
+ *                          ddc <roll> <pitch> <yaw> <throttle>
+ *                          waypoint <index> <command> <lat> <lon>
+ *                          takeoff | land | ddc_land | fts
+ *     --seed N             random seed (default 1)
+ *
+ * Parse time is measured on the host, so only compare it between runs or scale it to the target
+ */
+
+#include "arduino_mock.h"
+
+// Sketch configuration and state
+#include "../../config.h"
+#include "../../constants.h"
+#include "../../pid.h"
+#include "../../datatypes.h"
+
+// Sketch code under test
+#include "../../liberty_link_parser.ino"
+#include "../../liberty_link_handler.ino"
+#include "../../trajectory.ino"
+#include "../../pid_gps.ino"
+
+MockSerial Serial1, Serial2;
+MockTimer mock_timer_3, mock_timer_4;
+
+// Number of frames accepted by the parser (counted through link_telemetry_allowed)
+uint64_t parsed_frames;
+
+int MockSerial::read(void) {
+	// The previous byte has been fully processed by the parser at this point
+	if (link_telemetry_allowed) {
+		parsed_frames++;
+		link_telemetry_allowed = 0;
+	}
+
+	read_bytes++;
+	uint8_t data = rx.front();
+	rx.pop_front();
+	return data;
+}
+
+void leds_error_signal(void) { throw MockFtsTriggered(); }
+void delayMicroseconds(uint32_t) {}
+void sonarus_pid(void) {}
+void sonarus_pid_reset(void) {}
+
+// Generator settings
+double option_seconds = 60, option_rate = 50, option_waypoint_rate = 5, option_jitter = 0.2;
+double option_ber = 0, option_partial = 0, option_noise = 0;
+uint32_t option_baudrate = TELEMETRY_BAUDRATE, option_seed = 1;
+std::string option_script;
+
+std::mt19937 generator_random;
+std::uniform_real_distribution<double> generator_uniform(0., 1.);
+
+// Bytes on the wire (waiting for the UART), limited by the baud rate
+std::deque<uint8_t> generator_wire;
+uint64_t generator_packets, generator_bytes;
+
+/// <summary>
+/// Adds check byte and suffix to 9 data bytes and puts the packet on the wire
+/// with optional truncation and bit errors
+/// </summary>
+void generator_send(const uint8_t data[9]) {
+	uint8_t packet[12];
+	uint8_t check = 0;
+	for (int i = 0; i < 9; i++) {
+		packet[i] = data[i];
+		check ^= data[i];
+	}
+	packet[9] = check;
+	packet[10] = LINK_SUFFIX_1;
+	packet[11] = LINK_SUFFIX_2;
+
+	int length = 12;
+	if (generator_uniform(generator_random) < option_partial)
+		length = (int)(generator_uniform(generator_random) * 11);
+
+	for (int i = 0; i < length; i++) {
+		if (option_ber > 0)
+			for (int bit = 0; bit < 8; bit++)
+				if (generator_uniform(generator_random) < option_ber)
+					packet[i] ^= 1 << bit;
+		generator_wire.push_back(packet[i]);
+	}
+
+	generator_packets++;
+	generator_bytes += length;
+}
+
+/// <summary>
+/// Command packet: P = 0, CCC = command, XXXX = data
+/// </summary>
+void generator_command(uint8_t command, uint8_t command_data, const uint16_t values[4]) {
+	uint8_t data[9];
+	for (int i = 0; i < 4; i++) {
+		data[i * 2] = values[i] >> 8;
+		data[i * 2 + 1] = values[i];
+	}
+	data[8] = (command & 0b111) << 4 | (command_data & 0b1111);
+	generator_send(data);
+}
+
+/// <summary>
+/// Waypoint packet: P = 1, CCC = waypoint command, XXXX = waypoint index
+/// </summary>
+void generator_waypoint(uint8_t index, uint8_t command, int32_t lat, int32_t lon) {
+	uint8_t data[9];
+	for (int i = 0; i < 4; i++) {
+		data[i] = (uint32_t)lat >> (24 - i * 8);
+		data[4 + i] = (uint32_t)lon >> (24 - i * 8);
+	}
+	data[8] = 0b10000000 | (command & 0b111) << 4 | (index & 0b1111);
+	generator_send(data);
+}
+
+/// <summary>
+/// Sends one scripted packet
+/// </summary>
+void generator_script_packet(std::istringstream &line) {
+	std::string packet;
+	line >> packet;
+	uint16_t neutral[4] = { 1500, 1500, 1500, 1500 };
+
+	if (packet == "ddc") {
+		uint16_t values[4];
+		line >> values[0] >> values[1] >> values[2] >> values[3];
+		generator_command(CMD_BITS_DDC, 0, values);
+	}
+	else if (packet == "waypoint") {
+		int index, command;
+		int32_t lat, lon;
+		line >> index >> command >> lat >> lon;
+		generator_waypoint(index, command, lat, lon);
+	}
+	else if (packet == "takeoff")
+		generator_command(CMD_BITS_AUTO_TAKEOFF, 0, neutral);
+	else if (packet == "land")
+		generator_command(CMD_BITS_AUTO_LAND, 0, neutral);
+	else if (packet == "ddc_land")
+		generator_command(CMD_BITS_DDC_LAND, 0, neutral);
+	else if (packet == "fts")
+		generator_command(CMD_BITS_FTS, 0b1111, neutral);
+	else
+		fprintf(stderr, "Unknown scripted packet: %s\n", packet.c_str());
+}
+
+/// <summary>
+/// Returns the next send time with jitter
+/// </summary>
+double generator_next_time(double time, double rate) {
+	return time + (1. + option_jitter * (generator_uniform(generator_random) * 2. - 1.)) / rate;
+}
+
+// Sent waypoint update
+struct PendingWaypoint {
+	uint32_t loop;
+	int32_t lat, lon;
+
+	// Distance from the GPS setpoint to the waypoint when the handler picked it up
+	double distance;
+};
+
+/// <summary>
+/// Returns distance from the GPS setpoint to the waypoint (in GPS units)
+/// </summary>
+double setpoint_distance(const PendingWaypoint &waypoint) {
+	double lat = (double)waypoint.lat - l_lat_setpoint, lon = (double)waypoint.lon - l_lon_setpoint;
+	return sqrt(lat * lat + lon * lon);
+}
+
+int main(int argc, char **argv) {
+	for (int i = 1; i + 1 < argc; i += 2) {
+		std::string option = argv[i];
+		double value = atof(argv[i + 1]);
+		if (option == "--seconds") option_seconds = value;
+		else if (option == "--rate") option_rate = value;
+		else if (option == "--waypoint-rate") option_waypoint_rate = value;
+		else if (option == "--jitter") option_jitter = value;
+		else if (option == "--ber") option_ber = value;
+		else if (option == "--partial") option_partial = value;
+		else if (option == "--noise") option_noise = value;
+		else if (option == "--baudrate") option_baudrate = (uint32_t)value;
+		else if (option == "--rx-buffer") Serial1.rx_capacity = (size_t)value;
+		else if (option == "--script") option_script = argv[i + 1];
+		else if (option == "--seed") option_seed = (uint32_t)value;
+		else {
+			fprintf(stderr, "Unknown option: %s\n", option.c_str());
+			return 1;
+		}
+	}
+	generator_random.seed(option_seed);
+
+	// Scripted packets sorted by time
+	std::vector<std::pair<double, std::string>> script;
+	if (!option_script.empty()) {
+		std::ifstream file(option_script);
+		std::string line;
+		while (std::getline(file, line)) {
+			std::istringstream stream(line);
+			double time;
+			if (line.empty() || line[0] == '#' || !(stream >> time))
+				continue;
+			std::string rest;
+			std::getline(stream, rest);
+			script.push_back(std::make_pair(time, rest));
+		}
+		std::stable_sort(script.begin(), script.end(),
+			[](const std::pair<double, std::string> &a, const std::pair<double, std::string> &b) { return a.first < b.first; });
+	}
+
+	// Drone is flying a waypoint mission with Liberty-Link enabled
+	const int32_t lat_home = 55751244, lon_home = 37618423;
+	link_allowed = 1;
+	start = 2;
+	takeoff_detected = 1;
+	flight_mode = 3;
+	l_lat_gps = l_lat_setpoint = lat_home;
+	l_lon_gps = l_lon_setpoint = lon_home;
+	waypoints_lat[0] = lat_home + 5000;
+	waypoints_lon[0] = lon_home + 5000;
+	waypoints_command[0] = WAYP_CMD_BITS_FLY;
+	link_waypoint_step = LINK_STEP_WAYP_CALC;
+
+	const double loop_seconds = LOOP_PERIOD / 1000000.;
+	const uint32_t loops = (uint32_t)(option_seconds / loop_seconds);
+	const double wire_bytes_per_loop = option_baudrate / 10. * loop_seconds;
+	double wire_budget = 0;
+	double time_ddc = 0, time_waypoint = 0, time_noise = 0;
+	size_t script_index = 0;
+
+	std::vector<PendingWaypoint> pending;
+	PendingWaypoint waypoint_active = PendingWaypoint();
+	bool waypoint_waiting = false;
+	uint64_t waypoint_updates = 0, waypoint_received = 0, waypoint_moved = 0, waypoint_stalled = 0, waypoint_lost = 0;
+	int32_t setpoint_lat_previous = l_lat_setpoint, setpoint_lon_previous = l_lon_setpoint;
+	double setpoint_path = 0;
+	uint32_t latency_min = UINT32_MAX, latency_max = 0;
+	uint64_t latency_total = 0;
+
+	double parse_time_total = 0, parse_time_max = 0, handler_time_max = 0;
+	uint64_t parse_bytes_max = 0, rx_backlog_max = 0;
+	uint32_t fts_loop = 0;
+	bool fts_triggered = false;
+
+	uint32_t loop;
+	for (loop = 0; loop < loops && !fts_triggered; loop++) {
+		double time = loop * loop_seconds;
+
+		// Scripted packets
+		while (script_index < script.size() && script[script_index].first <= time) {
+			std::istringstream line(script[script_index].second);
+			generator_script_packet(line);
+			script_index++;
+		}
+
+		// Direct control packets
+		if (option_rate > 0)
+			while (time_ddc <= time) {
+				uint16_t values[4] = { (uint16_t)(1400 + generator_random() % 200), (uint16_t)(1400 + generator_random() % 200),
+					(uint16_t)(1400 + generator_random() % 200), (uint16_t)(1400 + generator_random() % 200) };
+				generator_command(CMD_BITS_DDC, 0, values);
+				time_ddc = generator_next_time(time_ddc, option_rate);
+			}
+
+		// Waypoint updates of the current waypoint (always different from the previous one)
+		if (option_waypoint_rate > 0)
+			while (time_waypoint <= time) {
+				PendingWaypoint update;
+				update.loop = loop;
+				update.lat = lat_home + 1000 + (int32_t)(waypoint_updates % 4000);
+				update.lon = lon_home - 1000 - (int32_t)(waypoint_updates % 4000);
+				generator_waypoint(waypoints_index, WAYP_CMD_BITS_FLY, update.lat, update.lon);
+				pending.push_back(update);
+				waypoint_updates++;
+				time_waypoint = generator_next_time(time_waypoint, option_waypoint_rate);
+			}
+
+		// Random garbage
+		if (option_noise > 0)
+			while (time_noise <= time) {
+				generator_wire.push_back((uint8_t)generator_random());
+				time_noise = generator_next_time(time_noise, option_noise);
+			}
+
+		// UART receives bytes from the wire limited by the baud rate
+		wire_budget += wire_bytes_per_loop;
+		while (wire_budget >= 1 && !generator_wire.empty()) {
+			Serial1.receive(generator_wire.front());
+			generator_wire.pop_front();
+			wire_budget--;
+		}
+		if (generator_wire.empty() && wire_budget > wire_bytes_per_loop)
+			wire_budget = wire_bytes_per_loop;
+		if (Serial1.rx.size() > rx_backlog_max)
+			rx_backlog_max = Serial1.rx.size();
+
+		// Main loop part under test
+		try {
+			uint64_t read_bytes = Serial1.read_bytes;
+			auto parse_start = std::chrono::steady_clock::now();
+			liberty_link_parser();
+			auto parse_end = std::chrono::steady_clock::now();
+			liberty_link_handler();
+			auto handler_end = std::chrono::steady_clock::now();
+
+			// Count the last frame of this call
+			if (link_telemetry_allowed) {
+				parsed_frames++;
+				link_telemetry_allowed = 0;
+			}
+
+			double parse_time = std::chrono::duration<double, std::micro>(parse_end - parse_start).count();
+			double handler_time = std::chrono::duration<double, std::micro>(handler_end - parse_end).count();
+			parse_time_total += parse_time;
+			if (parse_time > parse_time_max) {
+				parse_time_max = parse_time;
+				parse_bytes_max = Serial1.read_bytes - read_bytes;
+			}
+			if (handler_time > handler_time_max)
+				handler_time_max = handler_time;
+		}
+		catch (MockFtsTriggered &) {
+			fts_triggered = true;
+			fts_loop = loop;
+		}
+
+		// GPS setpoint progress
+		setpoint_path += sqrt((double)(l_lat_setpoint - setpoint_lat_previous) * (l_lat_setpoint - setpoint_lat_previous)
+			+ (double)(l_lon_setpoint - setpoint_lon_previous) * (l_lon_setpoint - setpoint_lon_previous));
+		setpoint_lat_previous = l_lat_setpoint;
+		setpoint_lon_previous = l_lon_setpoint;
+
+		// Waypoint picked up by the handler. Older updates superseded by the received one are lost
+		for (size_t i = 0; i < pending.size(); i++) {
+			if (pending[i].lat == l_lat_waypoint && pending[i].lon == l_lon_waypoint) {
+				if (waypoint_waiting)
+					waypoint_stalled++;
+				waypoint_active = pending[i];
+				waypoint_active.distance = setpoint_distance(waypoint_active);
+				waypoint_waiting = true;
+				waypoint_received++;
+				waypoint_lost += i;
+				pending.erase(pending.begin(), pending.begin() + i + 1);
+				break;
+			}
+		}
+
+		// Waypoint step latency. Wait until the setpoint starts moving towards the waypoint or reaches it
+		if (waypoint_waiting && (link_waypoint_step == LINK_STEP_GPS_SETP
+			|| setpoint_distance(waypoint_active) < waypoint_active.distance)) {
+			uint32_t latency = loop - waypoint_active.loop;
+			if (latency < latency_min) latency_min = latency;
+			if (latency > latency_max) latency_max = latency;
+			latency_total += latency;
+			waypoint_moved++;
+			waypoint_waiting = false;
+		}
+	}
+	waypoint_lost += pending.size();
+
+	double seconds = loop * loop_seconds;
+	printf("Simulated time:          %.2f s (%u loops)\n", seconds, loop);
+	printf("Packets sent:            %llu (%llu bytes, %.1f packets/s)\n",
+		(unsigned long long)generator_packets, (unsigned long long)generator_bytes, generator_packets / seconds);
+	printf("Frames parsed:           %llu (%.1f frames/s, %.1f%% of sent)\n", (unsigned long long)parsed_frames,
+		parsed_frames / seconds, generator_packets ? 100. * parsed_frames / generator_packets : 0.);
+	printf("RX overflow:             %llu bytes, max backlog %llu bytes, %zu bytes still on the wire\n",
+		(unsigned long long)Serial1.rx_overflow, (unsigned long long)rx_backlog_max, generator_wire.size());
+	printf("Parser time (host):      avg %.3f us, max %.3f us (%llu bytes in that call)\n",
+		loop ? parse_time_total / loop : 0., parse_time_max, (unsigned long long)parse_bytes_max);
+	printf("Handler time (host):     max %.3f us\n", handler_time_max);
+	if (waypoint_moved)
+		printf("Waypoint step latency:   min %u, avg %.2f, max %u loops (%.1f ms max)\n",
+			latency_min, (double)latency_total / waypoint_moved, latency_max, latency_max * loop_seconds * 1000.);
+	else
+		printf("Waypoint step latency:   no waypoint update moved the setpoint\n");
+	printf("Waypoint updates:        %llu sent, %llu received, %llu moved the setpoint, %llu stalled, %llu lost\n",
+		(unsigned long long)waypoint_updates, (unsigned long long)waypoint_received, (unsigned long long)waypoint_moved,
+		(unsigned long long)waypoint_stalled, (unsigned long long)waypoint_lost);
+	printf("GPS setpoint progress:   %.2f units/s (%.0f units in total, %.1f waypoint updates/s)\n",
+		seconds > 0 ? setpoint_path / seconds : 0., setpoint_path, option_waypoint_rate);
+	if (fts_triggered)
+		printf("FTS triggered at:        %.3f s\n", fts_loop * loop_seconds);
+
+	return 0;
+}
@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2022 Fern Lane, Liberty-X Flight controller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * The Liberty-X project started as a fork of the YMFC-32 project by Joop Brokking
+ *
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * IT IS STRICTLY PROHIBITED TO USE THE PROJECT (OR PARTS OF THE PROJECT / CODE)
+ * FOR MILITARY PURPOSES. ALSO, IT IS STRICTLY PROHIBITED TO USE THE PROJECT (OR PARTS OF THE PROJECT / CODE)
+ * FOR ANY PURPOSE THAT MAY LEAD TO INJURY, HUMAN, ANIMAL OR ENVIRONMENTAL DAMAGE.
+ * ALSO, IT IS PROHIBITED TO USE THE PROJECT (OR PARTS OF THE PROJECT / CODE) FOR ANY PURPOSE THAT
+ * VIOLATES INTERNATIONAL HUMAN RIGHTS OR HUMAN FREEDOM.
+ * BY USING THE PROJECT (OR PART OF THE PROJECT / CODE) YOU AGREE TO ALL OF THE ABOVE RULES.
+ */
+
+#ifdef LIBERTY_LINK
+
+/// <summary>
+/// Precalculates trapezoidal velocity profile (accelerate, cruise, decelerate) for the selected axis
+/// Units: distance in axis units, velocity in units per loop, acceleration in units per loop^2
+/// </summary>
+/// <param name="axis">TRAJECTORY_GPS or TRAJECTORY_ALTITUDE</param>
+/// <param name="distance">Absolute length of the path</param>
+/// <param name="velocity_initial">Velocity at the start of the path (along the path)</param>
+/// <param name="velocity_max">Maximum (cruise) velocity</param>
+/// <param name="acceleration">Acceleration and deceleration</param>
+void trajectory_start(uint8_t axis, float distance, float velocity_initial, float velocity_max, float acceleration) {
+    // Reset current time and position
+    trajectory_time[axis] = 0;
+    trajectory_position[axis] = 0;
+
+    // Nothing to do if the path is empty
+    if (distance <= 0) {
+        trajectory_velocity[axis] = 0;
+        trajectory_velocity_initial[axis] = 0;
+        trajectory_distance[axis] = 0;
+        trajectory_time_decelerate[axis] = 0;
+        trajectory_time_total[axis] = 0;
+        return;
+    }
+
+    // Initial velocity must be between 0 and the cruise velocity
+    if (velocity_initial < 0)
+        velocity_initial = 0;
+    if (velocity_initial > velocity_max)
+        velocity_initial = velocity_max;
+
+    // Reduce initial velocity if it's impossible to stop at the end of the path
+    if (velocity_initial * velocity_initial > 2.f * acceleration * distance)
+        velocity_initial = sqrt(2.f * acceleration * distance);
+    trajectory_velocity[axis] = velocity_initial;
+    trajectory_velocity_initial[axis] = velocity_initial;
+
+    // Time and distance of acceleration from the initial to the cruise velocity
+    trajectory_distance[axis] = distance;
+    trajectory_acceleration[axis] = acceleration;
+    trajectory_time_accelerate[axis] = (velocity_max - velocity_initial) / acceleration;
+    trajectory_distance_accelerate[axis] = 0.5f * (velocity_initial + velocity_max) * trajectory_time_accelerate[axis];
+
+    // Triangular profile if the path is too short to reach the cruise velocity
+    if (trajectory_distance_accelerate[axis] + 0.5f * velocity_max * velocity_max / acceleration > distance) {
+        velocity_max = sqrt(acceleration * distance + 0.5f * velocity_initial * velocity_initial);
+        trajectory_time_accelerate[axis] = (velocity_max - velocity_initial) / acceleration;
+        trajectory_distance_accelerate[axis] = 0.5f * (velocity_initial + velocity_max) * trajectory_time_accelerate[axis];
+    }
+    trajectory_velocity_cruise[axis] = velocity_max;
+
+    // Time when deceleration starts and total time of the profile
+    trajectory_time_decelerate[axis] = trajectory_time_accelerate[axis]
+        + (distance - trajectory_distance_accelerate[axis] - 0.5f * velocity_max * velocity_max / acceleration) / velocity_max;
+    trajectory_time_total[axis] = trajectory_time_decelerate[axis] + velocity_max / acceleration;
+}
+
+/// <summary>
+/// Stops the profile of the selected axis, so the next profile starts from zero velocity
+/// </summary>
+/// <param name="axis">TRAJECTORY_GPS or TRAJECTORY_ALTITUDE</param>
+void trajectory_stop(uint8_t axis) {
+    trajectory_start(axis, 0, 0, 0, 0);
+}
+
+/// <summary>
+/// Moves the profile of the selected axis one loop forward
+/// and calculates trajectory_position and trajectory_velocity
+/// </summary>
+/// <param name="axis">TRAJECTORY_GPS or TRAJECTORY_ALTITUDE</param>
+/// <returns>1 if the profile is still in progress, 0 if the end is reached</returns>
+boolean trajectory_step(uint8_t axis) {
+    // End of the profile
+    if ((float)trajectory_time[axis] >= trajectory_time_total[axis]) {
+        trajectory_position[axis] = trajectory_distance[axis];
+        trajectory_velocity[axis] = 0;
+        return 0;
+    }
+
+    // Increment time
+    trajectory_time[axis]++;
+    trajectory_time_temp = trajectory_time[axis];
+
+    // Acceleration
+    if (trajectory_time_temp < trajectory_time_accelerate[axis]) {
+        trajectory_velocity[axis] = trajectory_velocity_initial[axis] + trajectory_acceleration[axis] * trajectory_time_temp;
+        trajectory_position[axis] = 0.5f * (trajectory_velocity_initial[axis] + trajectory_velocity[axis]) * trajectory_time_temp;
+    }
+
+    // Cruise
+    else if (trajectory_time_temp < trajectory_time_decelerate[axis]) {
+        trajectory_velocity[axis] = trajectory_velocity_cruise[axis];
+        trajectory_position[axis] = trajectory_distance_accelerate[axis]
+            + trajectory_velocity[axis] * (trajectory_time_temp - trajectory_time_accelerate[axis]);
+    }
+
+    // Deceleration
+    else if (trajectory_time_temp < trajectory_time_total[axis]) {
+        trajectory_time_temp = trajectory_time_total[axis] - trajectory_time_temp;
+        trajectory_velocity[axis] = trajectory_acceleration[axis] * trajectory_time_temp;
+        trajectory_position[axis] = trajectory_distance[axis] - 0.5f * trajectory_velocity[axis] * trajectory_time_temp;
+    }
+
+    // Last step
+    else {
+        trajectory_position[axis] = trajectory_distance[axis];
+        trajectory_velocity[axis] = 0;
+    }
+
+    return 1;
+}
+
+/// <summary>
+/// Precalculates GPS leg from the current GPS setpoint to the current waypoint
+/// If the leg is re-targeted mid-flight, the new leg starts with the current velocity projected onto its direction
+/// </summary>
+void trajectory_gps_start(void) {
+    // Velocity of the leg in progress (in latitude units per loop). Keeps feed-forward until the first step of the new leg
+    trajectory_lat_velocity = trajectory_velocity[TRAJECTORY_GPS] * trajectory_lat_direction;
+    trajectory_lon_velocity = trajectory_velocity[TRAJECTORY_GPS] * trajectory_lon_direction * trajectory_lon_scale;
+
+    // Start of the leg. Sub-unit part of the setpoint is stored in the float adjustments
+    trajectory_lat_start = l_lat_setpoint;
+    trajectory_lon_start = l_lon_setpoint;
+    trajectory_lat_start_adjust = l_lat_gps_float_adjust;
+    trajectory_lon_start_adjust = l_lon_gps_float_adjust;
+
+    // Longitude units are shorter than latitude units, so scale them to get the real distance
+    trajectory_lon_scale = cos(((float)l_lat_setpoint / 1000000.0) * DEG_TO_RAD);
+
+    // Path from the start to the waypoint
+    trajectory_lat_direction = (float)(l_lat_waypoint - l_lat_setpoint) - trajectory_lat_start_adjust;
+    trajectory_lon_direction = (float)(l_lon_waypoint - l_lon_setpoint) - trajectory_lon_start_adjust;
+
+    // Length of the leg (in latitude units)
+    trajectory_distance_temp = sqrt(trajectory_lat_direction * trajectory_lat_direction
+        + trajectory_lon_direction * trajectory_lon_direction * trajectory_lon_scale * trajectory_lon_scale);
+
+    // Direction of the leg (setpoint change per unit of the path)
+    if (trajectory_distance_temp > 0) {
+        trajectory_lat_direction /= trajectory_distance_temp;
+        trajectory_lon_direction /= trajectory_distance_temp;
+    }
+    else {
+        trajectory_lat_direction = 0;
+        trajectory_lon_direction = 0;
+    }
+
+    // Precalculate profile starting with the current velocity along the new leg
+    trajectory_start(TRAJECTORY_GPS, trajectory_distance_temp,
+        trajectory_lat_velocity * trajectory_lat_direction + trajectory_lon_velocity * trajectory_lon_direction * trajectory_lon_scale,
+        WAYPOINT_GPS_MAX_SPEED, WAYPOINT_GPS_ACCELERATION);
+}
+
+/// <summary>
+/// Moves GPS setpoint along the precalculated leg and sets velocity feed-forward
+/// </summary>
+/// <returns>1 if the leg is still in progress, 0 if the waypoint is reached</returns>
+boolean trajectory_gps_step(void) {
+    // Step profile. Don't touch the setpoint after the end of the leg
+    if (!trajectory_step(TRAJECTORY_GPS)) {
+        trajectory_lat_velocity = 0;
+        trajectory_lon_velocity = 0;
+        return 0;
+    }
+
+    // Set GPS setpoint and keep its sub-unit part in the float adjustment
+    trajectory_setpoint_temp = trajectory_lat_start_adjust + trajectory_position[TRAJECTORY_GPS] * trajectory_lat_direction;
+    l_lat_setpoint = trajectory_lat_start + (int32_t)round(trajectory_setpoint_temp);
+    l_lat_gps_float_adjust = trajectory_setpoint_temp - round(trajectory_setpoint_temp);
+
+    trajectory_setpoint_temp = trajectory_lon_start_adjust + trajectory_position[TRAJECTORY_GPS] * trajectory_lon_direction;
+    l_lon_setpoint = trajectory_lon_start + (int32_t)round(trajectory_setpoint_temp);
+    l_lon_gps_float_adjust = trajectory_setpoint_temp - round(trajectory_setpoint_temp);
+
+    // Velocity feed-forward (in latitude units per loop)
+    trajectory_lat_velocity = trajectory_velocity[TRAJECTORY_GPS] * trajectory_lat_direction;
+    trajectory_lon_velocity = trajectory_velocity[TRAJECTORY_GPS] * trajectory_lon_direction * trajectory_lon_scale;
+
+    return 1;
+}
+
+/// <summary>
+/// Precalculates altitude profile from the current pressure setpoint to the pressure_target
+/// </summary>
+/// <param name="pressure_target">Target pressure setpoint</param>
+void trajectory_altitude_start(float pressure_target) {
+    // Start of the profile
+    trajectory_alt_start = pid_alt_setpoint;
+    trajectory_alt_setpoint = pid_alt_setpoint;
+
+    // Direction of the profile (-1 to ascent, 1 to descent)
+    if (pressure_target < pid_alt_setpoint)
+        trajectory_alt_direction = -1;
+    else
+        trajectory_alt_direction = 1;
+
+    // Precalculate profile
+    trajectory_start(TRAJECTORY_ALTITUDE, abs(pressure_target - pid_alt_setpoint), 0, WAYPOINT_ALTITUDE_TERM, WAYPOINT_ALTITUDE_ACCELERATION);
+}
+
+/// <summary>
+/// Moves pressure setpoint along the precalculated profile and sets velocity feed-forward
+/// </summary>
+/// <returns>1 if the profile is still in progress, 0 if the target is reached</returns>
+boolean trajectory_altitude_step(void) {
+    // Keep setpoint changes made outside of the profile (throttle stick, collision abort) by shifting the start
+    trajectory_alt_start += pid_alt_setpoint - trajectory_alt_setpoint;
+
+    // Step profile. Don't touch the setpoint after the end of the profile (so it can be changed by the caller)
+    if (!trajectory_step(TRAJECTORY_ALTITUDE)) {
+        trajectory_alt_velocity = 0;
+        return 0;
+    }
+
+    // Set pressure setpoint
+    pid_alt_setpoint = trajectory_alt_start + trajectory_position[TRAJECTORY_ALTITUDE] * trajectory_alt_direction;
+    trajectory_alt_setpoint = pid_alt_setpoint;
+
+    // Velocity feed-forward (in pascals per loop)
+    trajectory_alt_velocity = trajectory_velocity[TRAJECTORY_ALTITUDE] * trajectory_alt_direction;
+
+    return 1;
+}
+
+/// <summary>
+/// Resets velocity feed-forward of all axes
+/// </summary>
+void trajectory_reset_feed_forward(void) {
+    trajectory_lat_velocity = 0;
+    trajectory_lon_velocity = 0;
+    trajectory_alt_velocity = 0;
+}
+
+#endif